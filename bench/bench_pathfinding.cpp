@@ -0,0 +1,465 @@
+/**
+ * bench_pathfinding runs every pathfinding strategy over a set of seeded generated grids and the scene layouts
+ *
+ * Usage: ./bench_pathfinding [queries per map] [seed] (from the repository root, where the scene maps are read from)
+ *
+ * The large generated map (over a million vertices) runs a tenth of the queries (at least one), and skips the
+ * strategies that need tables built for each map. The speedups of parallel A* and delta-stepping over their thread counts
+ * are written to stderr.
+ *
+ * One CSV row is written to stdout per (map, strategy) pair so results can be diffed between releases.
+ * Progress information is written to stderr.
+ */
+#ifndef SEARCH_STATS_ENABLED
+#define SEARCH_STATS_ENABLED
+#endif
+
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <functional>
+#include <memory>
+#include <map>
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <sys/resource.h>
+#include "../src/utils/graph/graph.hpp"
+#include "../src/utils/graph/flat-graph.hpp"
+#include "../src/utils/graph/implicit-grid-graph.hpp"
+#include "../src/utils/graph/grid-map.hpp"
+#include "../src/utils/algorithm/algorithm.hpp"
+#include "../src/utils/algorithm/graph-search.hpp"
+#include "../src/utils/algorithm/contraction-hierarchy.hpp"
+#include "../src/utils/algorithm/next-hop-table.hpp"
+#include "../src/utils/algorithm/reservation-table.hpp"
+#include "../src/utils/algorithm/heuristic.hpp"
+#include "../src/utils/algorithm/stats.hpp"
+
+typedef AdjacencyListGraph<Grid<int>, int> GridGraph;
+
+// BenchMap represents a grid layout to run queries on
+struct BenchMap {
+    std::string name;
+    int rows;
+    int cols;
+    std::vector<bool> blocked; // Row-major list of blocked tiles
+    bool large = false;        // Large maps run fewer queries and skip the preprocessed strategies
+};
+
+// Strategy represents a named pathfinding strategy
+struct Strategy {
+    std::string name;
+    std::function<bool(std::vector<Edge<int>*>*, GridGraph*, Vertex<Grid<int>>*, Vertex<Grid<int>>*, SearchStats*)> search;
+    bool preprocessed = false; // Needs the tables built for each map
+};
+
+// Generate a grid where each tile is blocked with a given probability
+BenchMap generatedMap(int rows, int cols, float density, std::mt19937 *rng) {
+    BenchMap map;
+    map.name = "generated-" + std::to_string(cols) + "x" + std::to_string(rows);
+    map.rows = rows;
+    map.cols = cols;
+    map.blocked = std::vector<bool>(rows * cols, false);
+
+    std::uniform_real_distribution<float> distribution(0, 1);
+    for (int i = 0; i < rows * cols; i++) {
+        map.blocked[i] = distribution(*rng) < density;
+    }
+
+    return map;
+}
+
+// Load a map file shared with the scenes (run from the repository root)
+BenchMap fileMap(std::string name, int rows, int cols) {
+    BenchMap map;
+    map.name = name;
+    map.rows = rows;
+    map.cols = cols;
+
+    if (!readGridMap("./assets/" + name + ".map", rows, cols, &map.blocked)) {
+        std::cerr << "Could not read ./assets/" << name << ".map" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return map;
+}
+
+// Build the same 4-connected directed graph GridEnvironment uses for a map
+void buildGraph(GridGraph *graph, BenchMap *map, std::vector<Vertex<Grid<int>>*> *cells) {
+    cells->assign(map->rows * map->cols, nullptr);
+
+    for (int row = 0; row < map->rows; row++) {
+        for (int col = 0; col < map->cols; col++) {
+            if (!map->blocked[row * map->cols + col]) {
+                cells->at(row * map->cols + col) = graph->insertVertex(Grid<int>(row, col));
+            }
+        }
+    }
+
+    int dRow[] = {-1, 1, 0, 0};
+    int dCol[] = {0, 0, -1, 1};
+    for (int row = 0; row < map->rows; row++) {
+        for (int col = 0; col < map->cols; col++) {
+            Vertex<Grid<int>> *v = cells->at(row * map->cols + col);
+            if (v == nullptr) {
+                continue;
+            }
+
+            for (int i = 0; i < 4; i++) {
+                int r = row + dRow[i];
+                int c = col + dCol[i];
+                if (r >= 0 && r < map->rows && c >= 0 && c < map->cols && cells->at(r * map->cols + c) != nullptr) {
+                    graph->insertEdge(v, cells->at(r * map->cols + c), 1);
+                }
+            }
+        }
+    }
+}
+
+// Get a percentile from a sorted list of samples
+int64_t percentile(std::vector<int64_t> *sorted, float p) {
+    if (sorted->size() == 0) {
+        return 0;
+    }
+
+    std::vector<int64_t>::size_type index = (std::vector<int64_t>::size_type) (p * (sorted->size() - 1) + 0.5f);
+    return sorted->at(index);
+}
+
+// Sequential Dijkstra's algorithm run to every vertex of a flat graph, the baseline delta-stepping has to beat
+// Fills in the same distances and predecessors delta-stepping does (unreachable vertices keep the maximum distance and -1)
+void dijkstrasAll(FlatGraph<Grid<int>, int> *graph, int source, std::vector<int> *distance, std::vector<int> *predecessor, SearchStats *stats) {
+    SearchTimer timer(stats);
+
+    *distance = std::vector<int>(graph->numVertices(), std::numeric_limits<int>::max());
+    *predecessor = std::vector<int>(graph->numVertices(), -1);
+
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> openList;
+    distance->at(source) = 0;
+    openList.push(std::make_pair(0, source));
+    stats->nodesGenerated++;
+
+    while (openList.size() > 0) {
+        std::pair<int, int> current = openList.top();
+        openList.pop();
+        if (current.first > distance->at(current.second)) {
+            continue;
+        }
+        stats->nodesExpanded++;
+
+        for (int arc = graph->arcsBegin(current.second); arc < graph->arcsEnd(current.second); arc++) {
+            int w = graph->target(arc);
+            int cost = current.first + graph->weight(arc);
+            if (cost < distance->at(w)) {
+                distance->at(w) = cost;
+                predecessor->at(w) = current.second;
+                openList.push(std::make_pair(cost, w));
+                stats->nodesGenerated++;
+            }
+        }
+        stats->recordOpenList(openList.size());
+    }
+}
+
+// Read the path to an end vertex back from the predecessors of a single-source search
+bool pathFromPredecessors(std::vector<Edge<int>*> *path, FlatGraph<Grid<int>, int> *graph, const std::vector<int> &predecessor, int source, int target, SearchStats *stats) {
+    if (target != source && predecessor.at(target) == -1) {
+        return false;
+    }
+    for (int v = target; v != source; v = predecessor.at(v)) {
+        path->push_back(graph->edge(graph->arcBetween(predecessor.at(v), v)));
+    }
+    std::reverse(path->begin(), path->end());
+    stats->pathLength += path->size();
+    return true;
+}
+
+// Get the peak resident set size of the process in kilobytes
+long maxRSS() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+int main(int argc, char **argv) {
+    int queries = argc > 1 ? std::stoi(argv[1]) : 100;
+    unsigned int seed = argc > 2 ? std::stoul(argv[2]) : 42;
+
+    std::mt19937 rng(seed);
+
+    // Setup the maps to benchmark
+    std::vector<BenchMap> maps;
+    maps.push_back(fileMap("sceneA", 24, 32));
+    maps.push_back(fileMap("sceneC", 24, 32));
+    maps.push_back(generatedMap(24, 32, 0.2f, &rng));
+    maps.push_back(generatedMap(48, 64, 0.2f, &rng));
+
+    // The large map gets its own generator, so it doesn't move the queries picked on the other maps
+    std::mt19937 largeRng(seed);
+    maps.push_back(generatedMap(1024, 1280, 0.2f, &largeRng));
+    maps.back().large = true;
+
+    // Setup the strategies to benchmark
+    ManhattanHeuristic<int> manhattan;
+    EuclideanHeuristic<int> euclidean;
+    EuclideanSquaredHeuristic<int> euclideanSquared;
+
+    // Flat and implicit copies of the current map's graph for the strategies that run on them
+    FlatGraph<Grid<int>, int> flatGraph;
+    ImplicitGridGraph<int> gridGraph;
+    std::vector<Vertex<Grid<int>>*> cells;
+
+    // Preprocessed tables and shared state of the current map for the strategies that need them (set up before any query is timed)
+    std::unique_ptr<ContractionHierarchy<Grid<int>, int>> hierarchy;
+    std::unique_ptr<NextHopTable<Grid<int>, int>> nextHops;
+    std::vector<Vertex<Grid<int>>*> otherGoals;
+    ReservationTable<Vertex<Grid<int>>*> reservations;
+    const int cooperativeWindow = 16;
+
+    std::vector<Strategy> strategies;
+    strategies.push_back({"dijkstras", [](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        return Algorithm<Grid<int>, int>::dijkstras(path, graph, start, end, stats);
+    }});
+    strategies.push_back({"astar-manhattan", [&manhattan](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        return Algorithm<Grid<int>, int>::astar(path, graph, start, end, &manhattan, stats);
+    }});
+    strategies.push_back({"astar-euclidean", [&euclidean](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        return Algorithm<Grid<int>, int>::astar(path, graph, start, end, &euclidean, stats);
+    }});
+    strategies.push_back({"astar-euclidean-squared", [&euclideanSquared](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        return Algorithm<Grid<int>, int>::astar(path, graph, start, end, &euclideanSquared, stats);
+    }});
+    strategies.push_back({"bidirectional-dijkstra", [](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        return Algorithm<Grid<int>, int>::bidirectionalDijkstra(path, graph, start, end, stats);
+    }});
+    strategies.push_back({"bidirectional-astar-manhattan", [&manhattan](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        return Algorithm<Grid<int>, int>::bidirectionalAstar(path, graph, start, end, &manhattan, stats);
+    }});
+
+    strategies.push_back({"flat-astar-manhattan", [&manhattan, &flatGraph](std::vector<Edge<int>*> *path, GridGraph *, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        std::vector<int> arcs;
+        bool success = GraphSearch<FlatGraph<Grid<int>, int>>::astar(&arcs, &flatGraph, flatGraph.id(start), flatGraph.id(end), [&manhattan, &flatGraph](int from, int to) {
+            return manhattan.estimate(flatGraph.vertex(from), flatGraph.vertex(to));
+        }, stats);
+        for (int arc : arcs) {
+            path->push_back(flatGraph.edge(arc));
+        }
+        return success;
+    }});
+    strategies.push_back({"implicit-astar-manhattan", [&gridGraph, &cells](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        // Each arc of the path is the cell it leads into
+        std::vector<int> arcs;
+        int current = gridGraph.id(start->getElement().row, start->getElement().column);
+        bool success = GraphSearch<ImplicitGridGraph<int>>::astar(&arcs, &gridGraph, current, gridGraph.id(end->getElement().row, end->getElement().column), [&gridGraph](int from, int to) {
+            return std::abs(gridGraph.row(from) - gridGraph.row(to)) + std::abs(gridGraph.column(from) - gridGraph.column(to));
+        }, stats);
+        for (int to : arcs) {
+            for (Edge<int> *e : *graph->outgoingEdges(cells.at(current))) {
+                if (graph->opposite(cells.at(current), e) == cells.at(to)) {
+                    path->push_back(e);
+                    break;
+                }
+            }
+            current = to;
+        }
+        return success;
+    }});
+    const std::vector<unsigned int> parallelThreads = {1, 2, 4, 8};
+    for (unsigned int threads : parallelThreads) {
+        strategies.push_back({"parallel-astar-manhattan-" + std::to_string(threads), [&manhattan, threads](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+            return Algorithm<Grid<int>, int>::parallelAstar(path, graph, start, end, &manhattan, threads, stats);
+        }});
+    }
+    strategies.push_back({"dijkstras-all", [&flatGraph](std::vector<Edge<int>*> *path, GridGraph *, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        // Settles every vertex like delta-stepping, so the two can be compared
+        std::vector<int> distance;
+        std::vector<int> predecessor;
+        dijkstrasAll(&flatGraph, flatGraph.id(start), &distance, &predecessor, stats);
+        return pathFromPredecessors(path, &flatGraph, predecessor, flatGraph.id(start), flatGraph.id(end), stats);
+    }});
+    for (unsigned int threads : parallelThreads) {
+        strategies.push_back({"delta-stepping-" + std::to_string(threads), [&flatGraph, threads](std::vector<Edge<int>*> *path, GridGraph *, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+            // Delta-stepping settles every vertex, so the path to the end is read back from the predecessors afterwards
+            std::vector<int> distance;
+            std::vector<int> predecessor;
+            Algorithm<Grid<int>, int>::deltaStepping(&flatGraph, start, 1, &distance, &predecessor, threads, stats);
+            return pathFromPredecessors(path, &flatGraph, predecessor, flatGraph.id(start), flatGraph.id(end), stats);
+        }});
+    }
+    strategies.push_back({"contraction-hierarchy", [&hierarchy](std::vector<Edge<int>*> *path, GridGraph *, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        return hierarchy->path(path, start, end, stats);
+    }, true});
+    strategies.push_back({"next-hop-table", [&nextHops](std::vector<Edge<int>*> *path, GridGraph *, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        // Table lookups don't record search statistics, so only the path length is filled in
+        bool success = nextHops->path(path, start, end);
+        stats->pathLength += path->size();
+        return success;
+    }, true});
+    strategies.push_back({"nearest-goal-manhattan-5", [&manhattan, &otherGoals](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        // The end competes with the same four seeded goals on every query
+        std::vector<Vertex<Grid<int>>*> goals = otherGoals;
+        goals.insert(goals.begin(), end);
+        int reachedGoal;
+        return Algorithm<Grid<int>, int>::nearestGoal(path, &reachedGoal, graph, start, goals, &manhattan, stats);
+    }});
+    strategies.push_back({"cooperative-astar-manhattan-16", [&manhattan, &reservations, cooperativeWindow](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+        // Plan as agent 0 around the seeded agents' reservations, then turn the moves of the timed path into edges (waits have none)
+        std::vector<Vertex<Grid<int>>*> timedPath;
+        bool success = Algorithm<Grid<int>, int>::cooperativeAstar(&timedPath, graph, start, end, &manhattan, &reservations, 0, 0, cooperativeWindow, stats);
+        for (std::vector<Vertex<Grid<int>>*>::size_type i = 1; i < timedPath.size(); i++) {
+            for (Edge<int> *e : *graph->outgoingEdges(timedPath.at(i - 1))) {
+                if (graph->opposite(timedPath.at(i - 1), e) == timedPath.at(i)) {
+                    path->push_back(e);
+                    break;
+                }
+            }
+        }
+        return success;
+    }});
+    for (float epsilon : {0.2f, 0.5f}) {
+        std::string suffix = epsilon == 0.2f ? "1.2" : "1.5";
+        strategies.push_back({"weighted-astar-manhattan-" + suffix, [&manhattan, epsilon](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+            return Algorithm<Grid<int>, int>::weightedAstar(path, graph, start, end, &manhattan, epsilon, stats);
+        }});
+        strategies.push_back({"focal-astar-manhattan-" + suffix, [&manhattan, epsilon](std::vector<Edge<int>*> *path, GridGraph *graph, Vertex<Grid<int>> *start, Vertex<Grid<int>> *end, SearchStats *stats) {
+            return Algorithm<Grid<int>, int>::focalAstar(path, graph, start, end, &manhattan, epsilon, stats);
+        }});
+    }
+
+    std::cout << "map,rows,cols,vertices,edges,strategy,queries,solved,p50_ns,p99_ns,mean_ns,expanded_mean,generated_mean,reopened_mean,open_peak_max,path_length_mean,search_bytes_peak,max_rss_kb\n";
+
+    for (BenchMap &map : maps) {
+        GridGraph graph = GridGraph(true);
+        cells.clear();
+        buildGraph(&graph, &map, &cells);
+        flatGraph = FlatGraph<Grid<int>, int>(&graph);
+        gridGraph = ImplicitGridGraph<int>(map.rows, map.cols, 1);
+        for (int i = 0; i < map.rows * map.cols; i++) {
+            gridGraph.setBlocked(i / map.cols, i % map.cols, map.blocked.at(i));
+        }
+
+        // Pick the same seeded start and end tiles for every strategy
+        std::vector<Vertex<Grid<int>>*> open;
+        for (Vertex<Grid<int>> *v : cells) {
+            if (v != nullptr) {
+                open.push_back(v);
+            }
+        }
+        if (open.size() == 0) {
+            continue;
+        }
+
+        std::vector<std::pair<Vertex<Grid<int>>*, Vertex<Grid<int>>*>> pairs;
+        std::uniform_int_distribution<std::vector<Vertex<Grid<int>>*>::size_type> pick(0, open.size() - 1);
+        int mapQueries = map.large ? std::max(1, queries / 10) : queries;
+        for (int i = 0; i < mapQueries; i++) {
+            pairs.push_back(std::make_pair(open.at(pick(rng)), open.at(pick(rng))));
+        }
+
+        // Preprocess the map for the table strategies (the next-hop table alone would need a row per vertex of the large map)
+        hierarchy.reset();
+        nextHops.reset();
+        if (!map.large) {
+            std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+            hierarchy.reset(new ContractionHierarchy<Grid<int>, int>(&graph));
+            hierarchy->build();
+            std::cerr << "Built contraction hierarchy for " << map.name << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count() << " ms\n";
+
+            buildStart = std::chrono::steady_clock::now();
+            nextHops.reset(new NextHopTable<Grid<int>, int>(&graph));
+            nextHops->build();
+            std::cerr << "Built next-hop table for " << map.name << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count() << " ms\n";
+        }
+
+        // Seed the extra goals and the other agents' reservations
+        otherGoals.clear();
+        for (int i = 0; i < 4; i++) {
+            otherGoals.push_back(open.at(pick(rng)));
+        }
+        reservations = ReservationTable<Vertex<Grid<int>>*>();
+        for (int agent = 1; agent <= 4; agent++) {
+            std::vector<Vertex<Grid<int>>*> timedPath;
+            Vertex<Grid<int>> *agentStart = open.at(pick(rng));
+            if (Algorithm<Grid<int>, int>::cooperativeAstar(&timedPath, &graph, agentStart, open.at(pick(rng)), &manhattan, &reservations, agent, 0, cooperativeWindow)) {
+                for (int t = 0; t <= cooperativeWindow; t++) {
+                    reservations.reserve(timedPath.at(std::min<std::size_t>(t, timedPath.size() - 1)), t, agent);
+                }
+            } else {
+                reservations.reserve(agentStart, 0, agent);
+            }
+        }
+
+        // Mean latency of each strategy on this map, for the parallel speedups
+        std::map<std::string, int64_t> meanLatency;
+
+        for (Strategy &strategy : strategies) {
+            if (map.large && strategy.preprocessed) {
+                continue;
+            }
+            std::cerr << "Running " << strategy.name << " on " << map.name << "\n";
+
+            std::vector<int64_t> latencies;
+            SearchStats total;
+            std::size_t searchBytesPeak = 0;
+            int solved = 0;
+
+            for (std::pair<Vertex<Grid<int>>*, Vertex<Grid<int>>*> &pair : pairs) {
+                std::vector<Edge<int>*> path;
+                SearchStats stats;
+
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                bool success = strategy.search(&path, &graph, pair.first, pair.second, &stats);
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+                if (success) {
+                    solved++;
+                }
+                total.add(stats);
+
+                // Every expanded or open vertex holds one record during the search
+                std::size_t searchBytes = (stats.openListPeak + stats.nodesExpanded) * sizeof(GraphSearch<GridGraph>::Record);
+                searchBytesPeak = std::max(searchBytesPeak, searchBytes);
+            }
+
+            std::sort(latencies.begin(), latencies.end());
+            float count = (float) pairs.size();
+            meanLatency[strategy.name] = (int64_t) (total.elapsedNanoseconds / count);
+
+            std::cout << map.name << "," << map.rows << "," << map.cols << "," << graph.numVertices() << "," << graph.numEdges() << ",";
+            std::cout << strategy.name << "," << pairs.size() << "," << solved << ",";
+            std::cout << percentile(&latencies, 0.5f) << "," << percentile(&latencies, 0.99f) << "," << (int64_t) (total.elapsedNanoseconds / count) << ",";
+            std::cout << total.nodesExpanded / count << "," << total.nodesGenerated / count << "," << total.reopened / count << ",";
+            std::cout << total.openListPeak << "," << total.pathLength / count << "," << searchBytesPeak << "," << maxRSS() << "\n";
+        }
+
+        // Report how parallel A* scales with its threads, against itself on one thread and against sequential A*
+        for (unsigned int threads : parallelThreads) {
+            double latency = (double) meanLatency["parallel-astar-manhattan-" + std::to_string(threads)];
+            std::cerr << "parallel-astar-manhattan on " << map.name << " with " << threads << " threads: ";
+            std::cerr << meanLatency["parallel-astar-manhattan-1"] / latency << "x over 1 thread, ";
+            std::cerr << meanLatency["astar-manhattan"] / latency << "x over astar-manhattan\n";
+        }
+
+        // And how delta-stepping scales, against itself on one thread and against sequential Dijkstra's to every vertex
+        for (unsigned int threads : parallelThreads) {
+            double latency = (double) meanLatency["delta-stepping-" + std::to_string(threads)];
+            std::cerr << "delta-stepping on " << map.name << " with " << threads << " threads: ";
+            std::cerr << meanLatency["delta-stepping-1"] / latency << "x over 1 thread, ";
+            std::cerr << meanLatency["dijkstras-all"] / latency << "x over dijkstras-all\n";
+        }
+
+        // Free the graph's vertices and edges before the next map
+        for (Edge<int> *e : graph.edges()) {
+            delete e;
+        }
+        for (Vertex<Grid<int>> *v : graph.vertices()) {
+            delete v;
+        }
+    }
+
+    return 0;
+}
@@ -7,12 +7,21 @@
 #include "../mouse/mouse.hpp"
 #include "../utils/vmath/vmath.hpp"
 #include "../utils/graph/graph.hpp"
-#include "../utils/algorithm/algorithm.hpp"
+#include "../utils/algorithm/graph-search.hpp"
+#include "../utils/graph/grid-map.hpp"
 #include "../utils/algorithm/heuristic.hpp"
 
 // Default constructor for an engine
 Engine::Engine(std::string title, Settings *settings) : sf::RenderWindow(sf::VideoMode(settings->width, settings->height), title), environment(settings->xTiles, settings->yTiles, settings->width, settings->height) {
     this->settings = settings;
+
+    this->obstacleLayer.create(settings->width, settings->height);
+
+    // Any change to the obstacle layout invalidates the navigation mesh and the contraction hierarchy
+    this->environment.addCellListener([this](int, int, bool) {
+        this->navMeshStale = true;
+        this->hierarchy.reset();
+    });
 }
 
 float mouseX;
@@ -57,6 +66,10 @@ void Engine::handleEvents() {
 
 // Handle updating entities in the window
 void Engine::update(sf::Time dt) {
+    // Start a new frame of pathfinding statistics
+    SEARCH_STATS(this->lastFrameSearchStats = this->frameSearchStats;)
+    SEARCH_STATS(this->frameSearchStats = SearchStats();)
+
     // Calculate time for the behavior update clock
     this->timeSinceLastBehaviorUpdate += this->behaviorUpdateClk.restart();
     bool shouldUpdate = this->timeSinceLastBehaviorUpdate >= this->settings->timePerDecision;
@@ -111,9 +124,25 @@ void Engine::update(sf::Time dt) {
             recording->writePacket(this->timestamp);
         }
         this->timestamp++;
+
+        // Reservations in the past can no longer cause conflicts
+        this->reservations.releaseBefore(this->timestamp);
     }
 }
 
+// Draw every obstacle into the off-screen obstacle layer
+void Engine::renderObstacleLayer() {
+    this->obstacleLayer.clear(sf::Color::Transparent);
+    for (Obstacle* o : *this->environment.getObstacles()) {
+        this->obstacleLayer.draw(*o);
+    }
+    this->obstacleLayer.display();
+
+    this->obstacleLayerSprite.setTexture(this->obstacleLayer.getTexture(), true);
+    this->obstacleLayerCount = this->environment.getObstacles()->size();
+    this->obstacleLayerStale = false;
+}
+
 // Render the next update cycle of the game
 void Engine::render() {
     // Update the mouse handler class
@@ -121,10 +150,11 @@ void Engine::render() {
 
     this->clear(this->settings->background);
 
-    // Draw all obstacles
-    for (Obstacle* o : *this->environment.getObstacles()) {
-        this->draw(*o);
+    // Draw all obstacles (obstacles added or removed through the environment directly are caught by the count)
+    if (this->obstacleLayerStale || this->obstacleLayerCount != this->environment.getObstacles()->size()) {
+        this->renderObstacleLayer();
     }
+    this->draw(this->obstacleLayerSprite);
 
     // Draw all breadcrumbs
     for (Array::size_type i = 0; i < this->entities.size(); i++) {
@@ -153,6 +183,55 @@ void Engine::newEntity(Entity *entity) {
 // Create a new obstacle in the game
 void Engine::newObstacle(GridObstacle *obstacle) {
     this->environment.addObstacle(obstacle);
+    this->obstacleLayerStale = true;
+}
+
+// Load the obstacles of a grid map file, textured and sized to fill their tiles (returns false if the file can't be read)
+bool Engine::loadMap(std::string filename, const sf::Texture &obstacleTexture) {
+    std::vector<bool> blocked;
+    if (!readGridMap(filename, this->settings->yTiles, this->settings->xTiles, &blocked)) {
+        return false;
+    }
+
+    // Scale the texture the same way the tiles are sized
+    float tileWidth = this->settings->width / this->settings->xTiles;
+    float tileHeight = this->settings->height / this->settings->yTiles;
+    sf::Vector2f scale(tileWidth / obstacleTexture.getSize().x, tileHeight / obstacleTexture.getSize().y);
+
+    std::vector<GridObstacle*> obstacles;
+    for (int i = 0; i < this->settings->xTiles * this->settings->yTiles; i++) {
+        if (blocked.at(i)) {
+            GridObstacle *o = new GridObstacle(Grid(i / this->settings->xTiles, i % this->settings->xTiles));
+            o->setTexture(obstacleTexture);
+            o->scale(scale);
+            obstacles.push_back(o);
+        }
+    }
+
+    this->environment.addObstacles(obstacles);
+    this->obstacleLayerStale = true;
+
+    // The loaded layout stays static until a tile changes, so exact searches can run on a contraction hierarchy (saved next to the map)
+    this->hierarchy.reset(new ContractionHierarchy<Grid<int>, int>(this->environment.getGraph()));
+    loadOrBuildContractionHierarchy(this->hierarchy.get(), filename);
+    return true;
+}
+
+// Remove an obstacle from the game environment (such as a crate that was moved)
+void Engine::removeObstacle(GridObstacle *obstacle) {
+    this->environment.removeObstacle(obstacle);
+    this->obstacleLayerStale = true;
+}
+
+// Block or open a tile of the game environment without an obstacle sprite (such as a door)
+void Engine::setCellBlocked(int row, int col, bool blocked) {
+    this->environment.setCellBlocked(row, col, blocked);
+}
+
+// Change the cost of moving into a tile of the game environment (such as mud), dropping the contraction hierarchy built on the old costs
+void Engine::setCellCost(int row, int col, int cost) {
+    this->environment.setCellCost(row, col, cost);
+    this->hierarchy.reset();
 }
 
 // Add a new recorder for an entity
@@ -212,6 +291,9 @@ void Engine::start() {
         }
 
         this->render();
+
+        // Spend what is left of the frame resolving queued path requests
+        this->processPathRequests();
     }
 }
 
@@ -277,34 +359,412 @@ std::vector<Entity> Engine::getEntitiesInRadius(float n, Target entity) {
 }
 
 // Pathfind from a given position in the game environment to the next
-std::vector<Edge<int>*> Engine::pathfind(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic) {
+// A positive epsilon trades optimality for speed: the path costs at most (1 + epsilon) times the optimal cost
+std::vector<Edge<int>*> Engine::pathfind(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, const char *caller, float epsilon, bool focal) {
     // Quantize the start and end positions
-    Vertex<Grid<int>> *startVertex = this->environment.quantize(currentPosition);
-    Vertex<Grid<int>> *endVertex = this->environment.quantize(goalPosition);
+    Vertex<Grid<int>> *startVertex = this->quantizeStart(currentPosition);
+    Vertex<Grid<int>> *endVertex = this->quantizeGoal(goalPosition, startVertex);
+
+    // Don't search if the goal can't be reached
+    if (endVertex == nullptr) {
+        return std::vector<Edge<int>*>();
+    }
+
+    return this->search(startVertex, endVertex, heuristic, caller, epsilon, focal);
+}
 
+// Quantize a position to start a path from (positions inside obstacles start from the closest open tile)
+Vertex<Grid<int>> *Engine::quantizeStart(sf::Vector2f position) {
+    Vertex<Grid<int>> *vertex = this->environment.quantize(position);
+    if (vertex == nullptr) {
+        vertex = this->environment.nearestInComponent(position, -1);
+    }
+
+    return vertex;
+}
+
+// Quantize a goal position, redirecting goals that can't be reached to the closest tile that can (or nullptr if there is none)
+Vertex<Grid<int>> *Engine::quantizeGoal(sf::Vector2f position, Vertex<Grid<int>> *startVertex) {
     if (startVertex == nullptr) {
-        startVertex = this->environment.quantize(sf::Vector2f(320, 240));
+        return nullptr;
+    }
+
+    Vertex<Grid<int>> *vertex = this->environment.quantize(position);
+    if (!this->environment.isReachable(startVertex, vertex)) {
+        vertex = this->environment.nearestInComponent(position, this->environment.getComponent(startVertex));
+    }
+
+    return vertex;
+}
+
+// Return true if there is a path between two positions
+bool Engine::isReachable(sf::Vector2f currentPosition, sf::Vector2f goalPosition) {
+    return this->environment.isReachable(this->environment.quantize(currentPosition), this->environment.quantize(goalPosition));
+}
+
+// Get the implicit grid cell of a vertex
+int Engine::cellOf(Vertex<Grid<int>> *vertex) {
+    return this->environment.getGridGraph()->id(vertex->getElement().row, vertex->getElement().column);
+}
+
+// Get the vertex of an implicit grid cell (or nullptr if the cell is blocked)
+Vertex<Grid<int>> *Engine::vertexOf(int cell) {
+    ImplicitGridGraph<int> *graph = this->environment.getGridGraph();
+    return this->environment.getVertex(graph->row(cell), graph->column(cell));
+}
+
+// Estimate the cost between two open cells of the implicit grid
+int Engine::estimate(Heuristic<Grid<int>, int> *heuristic, int from, int to) {
+    return heuristic == nullptr ? 0 : heuristic->estimate(this->vertexOf(from), this->vertexOf(to));
+}
+
+// Map a path of implicit grid cells back onto the environment graph's edges
+void Engine::cellsToEdges(int startCell, const std::vector<int> &cells, std::vector<Edge<int>*> *path) {
+    ImplicitGridGraph<int> *graph = this->environment.getGridGraph();
+
+    int from = startCell;
+    for (int to : cells) {
+        path->push_back(this->environment.getEdge(graph->row(from), graph->column(from), graph->row(to), graph->column(to)));
+        from = to;
+    }
+}
+
+// Find the shortest path between two vertices of the game environment
+std::vector<Edge<int>*> Engine::search(Vertex<Grid<int>> *startVertex, Vertex<Grid<int>> *endVertex, Heuristic<Grid<int>, int> *heuristic, const char *caller, float epsilon, bool focal) {
+    std::vector<Edge<int>*> path;
+    SearchStats *stats = nullptr;
+    SEARCH_STATS(SearchStats searchStats;)
+    SEARCH_STATS(stats = &searchStats;)
+
+    // Exact searches use the map's contraction hierarchy while it is valid
+    bool success;
+    if (epsilon <= 0 && this->hierarchy != nullptr) {
+        success = this->hierarchy->path(&path, startVertex, endVertex, stats);
+    } else {
+        // Everything else runs on the environment's implicit grid
+        ImplicitGridGraph<int> *graph = this->environment.getGridGraph();
+        int start = this->cellOf(startVertex);
+        int end = this->cellOf(endVertex);
+
+        // Requests queued before a tile was blocked may start or end on it
+        if (graph->isBlocked(graph->row(start), graph->column(start)) || graph->isBlocked(graph->row(end), graph->column(end))) {
+            success = false;
+        } else {
+            auto estimate = [this, heuristic](int from, int to) {
+                return this->estimate(heuristic, from, to);
+            };
+
+            std::vector<int> cells;
+            if (epsilon <= 0) {
+                success = GraphSearch<ImplicitGridGraph<int>>::astar(&cells, graph, start, end, estimate, stats);
+            } else if (focal) {
+                success = GraphSearch<ImplicitGridGraph<int>>::focalAstar(&cells, graph, start, end, estimate, epsilon, stats);
+            } else {
+                success = GraphSearch<ImplicitGridGraph<int>>::weightedAstar(&cells, graph, start, end, estimate, epsilon, stats);
+            }
+            this->cellsToEdges(start, cells, &path);
+        }
+    }
+
+    // Aggregate the statistics for this frame and the calling behavior
+    SEARCH_STATS(this->frameSearchStats.add(searchStats);)
+    SEARCH_STATS(this->callerSearchStats[caller].add(searchStats);)
+
+    if (!success) {
+        return std::vector<Edge<int>*>();
+    }
+
+    return path;
+}
+
+// Queue a path request to be resolved after the next frame is rendered (returns a ticket to poll for the result)
+// Identical pending requests share a single search and take on the most urgent of their priorities
+int Engine::requestPath(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, PathPriority priority, const char *caller, float epsilon, bool focal) {
+    // Quantize the start and end positions
+    Vertex<Grid<int>> *startVertex = this->quantizeStart(currentPosition);
+    Vertex<Grid<int>> *endVertex = this->quantizeGoal(goalPosition, startVertex);
+
+    // Resolve requests that can't be reached right away
+    if (endVertex == nullptr) {
+        this->pathResults[this->nextTicket] = std::vector<Edge<int>*>();
+        this->pathResultWaiters[this->nextTicket] = 1;
+        return this->nextTicket++;
+    }
+
+    // Share the search with an identical pending request
+    for (PathRequest &request : this->pathRequests) {
+        if (request.startVertex == startVertex && request.endVertex == endVertex && request.heuristic == heuristic && request.epsilon == epsilon && request.focal == focal) {
+            request.waiters++;
+            request.priority = std::min(request.priority, priority);
+            return request.ticket;
+        }
+    }
+
+    PathRequest request;
+    request.ticket = this->nextTicket++;
+    request.sequence = request.ticket;
+    request.waiters = 1;
+    request.priority = priority;
+    request.startVertex = startVertex;
+    request.endVertex = endVertex;
+    request.heuristic = heuristic;
+    request.epsilon = epsilon;
+    request.focal = focal;
+    request.caller = caller;
+
+    this->pathRequests.push_back(request);
+    return request.ticket;
+}
+
+// Collect the result of a path request (returns false if the request has not been resolved yet)
+bool Engine::pollPath(int ticket, std::vector<Edge<int>*> *path) {
+    std::map<int, std::vector<Edge<int>*>>::iterator it = this->pathResults.find(ticket);
+    if (it == this->pathResults.end()) {
+        return false;
+    }
+
+    *path = it->second;
+
+    // Forget the result once every requester has collected it
+    this->pathResultWaiters[ticket]--;
+    if (this->pathResultWaiters[ticket] <= 0) {
+        this->pathResults.erase(it);
+        this->pathResultWaiters.erase(ticket);
+    }
+
+    return true;
+}
+
+// Give up on a path request (the search is skipped if nobody else is waiting on it)
+void Engine::cancelPath(int ticket) {
+    for (std::vector<PathRequest>::size_type i = 0; i < this->pathRequests.size(); i++) {
+        if (this->pathRequests.at(i).ticket == ticket) {
+            this->pathRequests.at(i).waiters--;
+            if (this->pathRequests.at(i).waiters <= 0) {
+                this->pathRequests.erase(this->pathRequests.begin() + i);
+            }
+            return;
+        }
     }
+
+    // The request was already resolved, so treat it as collected
+    std::vector<Edge<int>*> path;
+    this->pollPath(ticket, &path);
+}
+
+// Get the priority a path request made from a given position should have
+PathPriority Engine::pathPriority(sf::Vector2f position) {
+    if (this->playerCharacter == nullptr) {
+        return PathPriority::Distant;
+    }
+
+    float distance = Vmath::length(position - this->playerCharacter->getPosition());
+    if (distance < this->settings->pathVisibleDistance) {
+        return PathPriority::Visible;
+    } else if (distance < this->settings->pathNearDistance) {
+        return PathPriority::Near;
+    }
+
+    return PathPriority::Distant;
+}
+
+// Resolve queued path requests, most urgent first, until the per-frame budget runs out
+void Engine::processPathRequests() {
+    if (this->pathRequests.size() == 0) {
+        return;
+    }
+
+    // Order the requests by priority, keeping requests of the same priority in the order they were made
+    std::sort(this->pathRequests.begin(), this->pathRequests.end(), [](const PathRequest &a, const PathRequest &b) {
+        if (a.priority != b.priority) {
+            return a.priority < b.priority;
+        }
+        return a.sequence < b.sequence;
+    });
+
+    // Always resolve at least one request so the queue keeps draining
+    sf::Clock budgetClk;
+    std::vector<PathRequest>::size_type resolved = 0;
+    while (resolved < this->pathRequests.size() && (resolved == 0 || budgetClk.getElapsedTime() < this->settings->pathfindBudget)) {
+        PathRequest &request = this->pathRequests.at(resolved);
+
+        this->pathResults[request.ticket] = this->search(request.startVertex, request.endVertex, request.heuristic, request.caller, request.epsilon, request.focal);
+        this->pathResultWaiters[request.ticket] = request.waiters;
+        resolved++;
+    }
+
+    this->pathRequests.erase(this->pathRequests.begin(), this->pathRequests.begin() + resolved);
+}
+
+// Register a new agent that pathfinds cooperatively with the others
+int Engine::newCooperativeAgent() {
+    return this->cooperativeAgents++;
+}
+
+// Pathfind around other agents' reservations for a window of timesteps, then reserve the path (one vertex per decision timestep)
+// The result holds the vertex reserved for each timestep, and ends early at the first slot another agent already holds
+std::vector<Vertex<Grid<int>>*> Engine::pathfindCooperative(int agent, sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, int window, const char *caller) {
+    // Quantize the start and end positions
+    Vertex<Grid<int>> *startVertex = this->quantizeStart(currentPosition);
+    Vertex<Grid<int>> *endVertex = this->quantizeGoal(goalPosition, startVertex);
+
+    // Our old reservations should not block our new plan
+    this->reservations.release(agent);
+
+    // If we're stuck inside an obstacle or nothing can be reached, there is nothing to plan
     if (endVertex == nullptr) {
-        endVertex = this->environment.quantize(sf::Vector2f(320, 240));
+        return std::vector<Vertex<Grid<int>>*>();
+    }
+
+    // Find the shortest path through space-time on the implicit grid
+    std::vector<int> timedCells;
+    SearchStats *stats = nullptr;
+    SEARCH_STATS(SearchStats searchStats;)
+    SEARCH_STATS(stats = &searchStats;)
+
+    bool success = GraphSearch<ImplicitGridGraph<int>>::cooperativeAstar(&timedCells, this->environment.getGridGraph(), this->cellOf(startVertex), this->cellOf(endVertex), [this, heuristic](int from, int to) {
+        return this->estimate(heuristic, from, to);
+    }, &this->reservations, agent, this->timestamp, window, stats);
+
+    // Aggregate the statistics for this frame and the calling behavior
+    SEARCH_STATS(this->frameSearchStats.add(searchStats);)
+    SEARCH_STATS(this->callerSearchStats[caller].add(searchStats);)
+
+    // If we're boxed in, wait where we are
+    if (!success) {
+        timedCells.clear();
+        timedCells.push_back(this->cellOf(startVertex));
+    }
+
+    // Reserve the path, staying on its last vertex until the end of the window
+    // The search doesn't check the slots spent waiting at the end of the path (or in place when boxed in), so stop at the first one that is taken
+    std::vector<Vertex<Grid<int>>*> reserved;
+    for (int i = 0; i <= window; i++) {
+        int cell = timedCells.at(std::min(i, (int) timedCells.size() - 1));
+        if (!this->reservations.reserve(cell, this->timestamp + i, agent)) {
+            break;
+        }
+        reserved.push_back(this->vertexOf(cell));
+    }
+
+    return reserved;
+}
+
+// Pathfind from a given position to whichever of the goal positions is closest, in a single search
+std::vector<Edge<int>*> Engine::pathfindToNearest(sf::Vector2f currentPosition, std::vector<sf::Vector2f> goalPositions, Heuristic<Grid<int>, int> *heuristic, int *reachedGoal, const char *caller) {
+    *reachedGoal = -1;
+
+    // Quantize the start position
+    Vertex<Grid<int>> *startVertex = this->quantizeStart(currentPosition);
+
+    // Quantize each reachable goal, remembering which goal position each cell came from
+    std::vector<int> goalCells;
+    std::vector<int> goalIndices;
+    for (std::vector<sf::Vector2f>::size_type i = 0; i < goalPositions.size(); i++) {
+        Vertex<Grid<int>> *goalVertex = this->environment.quantize(goalPositions.at(i));
+        if (this->environment.isReachable(startVertex, goalVertex)) {
+            goalCells.push_back(this->cellOf(goalVertex));
+            goalIndices.push_back(i);
+        }
+    }
+
+    if (goalCells.size() == 0) {
+        return std::vector<Edge<int>*>();
     }
 
-    // Find the shortest path
+    // Find the shortest path to the nearest goal
     std::vector<Edge<int>*> path;
-    bool success = Algorithm<Grid<int>, int>::astar(&path, this->environment.getGraph(), startVertex, endVertex, heuristic);
+    SearchStats *stats = nullptr;
+    SEARCH_STATS(SearchStats searchStats;)
+    SEARCH_STATS(stats = &searchStats;)
+
+    std::vector<int> cells;
+    int reachedCell = -1;
+    bool success = GraphSearch<ImplicitGridGraph<int>>::nearestGoal(&cells, &reachedCell, this->environment.getGridGraph(), this->cellOf(startVertex), goalCells, [this, heuristic](int from, int to) {
+        return this->estimate(heuristic, from, to);
+    }, stats);
+    this->cellsToEdges(this->cellOf(startVertex), cells, &path);
+
+    // Aggregate the statistics for this frame and the calling behavior
+    SEARCH_STATS(this->frameSearchStats.add(searchStats);)
+    SEARCH_STATS(this->callerSearchStats[caller].add(searchStats);)
 
     if (!success) {
         return std::vector<Edge<int>*>();
     }
 
+    *reachedGoal = goalIndices.at(reachedCell);
     return path;
 }
 
+// Pathfind between two positions on the environment chosen in the settings, returning the positions to move through
+// On the grid these are tile centers (the heuristic guides the search), and on the navigation mesh they are the corners of the smoothed path
+std::vector<sf::Vector2f> Engine::pathfindWaypoints(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, const char *caller) {
+    std::vector<sf::Vector2f> waypoints;
+
+    if (this->settings->navigation == Navigation::Grid) {
+        std::vector<Edge<int>*> path = this->pathfind(currentPosition, goalPosition, heuristic, caller);
+        if (path.size() == 0) {
+            return waypoints;
+        }
+
+        waypoints.push_back(currentPosition);
+        for (Edge<int> *edge : path) {
+            waypoints.push_back(this->environment.localizeEndpoint(edge, 1));
+        }
+        return waypoints;
+    }
+
+    // Move positions inside obstacles and goals that can't be reached onto open tiles, the same as on the grid
+    Vertex<Grid<int>> *startVertex = this->quantizeStart(currentPosition);
+    Vertex<Grid<int>> *endVertex = this->quantizeGoal(goalPosition, startVertex);
+    if (endVertex == nullptr) {
+        return waypoints;
+    }
+    if (startVertex != this->environment.quantize(currentPosition)) {
+        currentPosition = this->environment.localize(startVertex);
+    }
+    if (endVertex != this->environment.quantize(goalPosition)) {
+        goalPosition = this->environment.localize(endVertex);
+    }
+
+    SearchStats *stats = nullptr;
+    SEARCH_STATS(SearchStats searchStats;)
+    SEARCH_STATS(stats = &searchStats;)
+
+    this->getNavMesh()->findPath(currentPosition, goalPosition, &waypoints, stats);
+
+    // Aggregate the statistics for this frame and the calling behavior
+    SEARCH_STATS(this->frameSearchStats.add(searchStats);)
+    SEARCH_STATS(this->callerSearchStats[caller].add(searchStats);)
+
+    return waypoints;
+}
+
+// Get the pathfinding statistics of the last completed frame
+SearchStats Engine::getFrameSearchStats() {
+    return this->lastFrameSearchStats;
+}
+
+// Get the pathfinding statistics accumulated for each caller of pathfind
+std::map<std::string, SearchStats> *Engine::getCallerSearchStats() {
+    return &this->callerSearchStats;
+}
+
 // Get the environment
 GridEnvironment *Engine::getEnvironment() {
     return &this->environment;
 }
 
+// Get the navigation mesh over the environment (built from the current obstacle layout)
+NavMeshEnvironment *Engine::getNavMesh() {
+    if (this->navMeshStale) {
+        this->navMesh.reset(new NavMeshEnvironment(&this->environment, this->settings->xTiles, this->settings->yTiles, this->settings->width, this->settings->height));
+        this->navMeshStale = false;
+    }
+    return this->navMesh.get();
+}
+
 // Find the nearest obstacle in a given direction
 float Engine::nearestObstacle(sf::Vector2f position, Direction direction) {
     // Find the changes in width/height
@@ -334,22 +794,50 @@ float Engine::nearestObstacle(sf::Vector2f position, Direction direction) {
             break;
     }
 
-    // Parametrize the current position and look for obstacles in a given direction
+    // Look up how many tiles the march in this direction takes (rows step by dx and columns by dy, as they always have)
     Vertex<Grid<int>> *currentVertex = this->environment.quantize(position);
 
     int row = currentVertex->getElement().row;
     int col = currentVertex->getElement().column;
 
-    float distance = 0;
-    while (row >= 0 && row < this->settings->yTiles && col >= 0 && col < this->settings->xTiles) {
-        row += dx;
-        col += dy;
-        distance += dd;
+    return this->environment.obstacleSteps(row, col, (int) dx, (int) dy) * dd;
+}
 
-        if (this->environment.isObstacle(row, col)) {
-            break;
-        }
+// Return true if the straight line between two positions crosses no obstacles
+bool Engine::lineOfSight(sf::Vector2f from, sf::Vector2f to) {
+    return this->environment.lineOfSight(from, to);
+}
+
+// Answer a batch of line of sight queries
+void Engine::lineOfSight(const std::vector<Ray> &rays, std::vector<bool> *visible) {
+    this->environment.lineOfSight(rays, visible);
+}
+
+// Get how far a line from one position towards another travels before hitting an obstacle
+float Engine::raycast(sf::Vector2f from, sf::Vector2f to) {
+    return this->environment.raycast(from, to);
+}
+
+// Answer a batch of raycasts
+void Engine::raycast(const std::vector<Ray> &rays, std::vector<float> *distances) {
+    this->environment.raycast(rays, distances);
+}
+
+// Return true if the tile of one position can see the tile of another (a bit test once the environment's visibility is precomputed)
+bool Engine::canSee(sf::Vector2f from, sf::Vector2f to) {
+    Vertex<Grid<int>> *fromVertex = this->environment.quantize(from);
+    Vertex<Grid<int>> *toVertex = this->environment.quantize(to);
+    if (fromVertex == nullptr || toVertex == nullptr) {
+        return false;
     }
 
-    return distance;
+    return this->environment.isVisible(fromVertex->getElement().row, fromVertex->getElement().column, toVertex->getElement().row, toVertex->getElement().column);
+}
+
+// Find which of a set of viewers can see a target (such as every entity that can see the player)
+void Engine::canSee(const std::vector<sf::Vector2f> &viewers, sf::Vector2f target, std::vector<bool> *sees) {
+    sees->resize(viewers.size());
+    for (std::vector<sf::Vector2f>::size_type i = 0; i < viewers.size(); i++) {
+        (*sees)[i] = this->canSee(viewers[i], target);
+    }
 }
\ No newline at end of file
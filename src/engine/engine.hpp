@@ -4,12 +4,23 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <map>
+#include <memory>
 #include "../entity/entity.hpp"
 #include "../utils/array/array.hpp"
 #include "../mouse/mouse.hpp"
 #include "../utils/graph/graph.hpp"
 #include "../environment/environment.hpp"
+#include "../environment/navmesh-environment.hpp"
 #include "../utils/algorithm/heuristic.hpp"
+#include "../utils/algorithm/stats.hpp"
+#include "../utils/algorithm/reservation-table.hpp"
+#include "../utils/algorithm/contraction-hierarchy.hpp"
+
+// Navigation represents which environment waypoint paths are planned on
+enum class Navigation {
+    Grid,
+    NavMesh
+};
 
 // Settings struct helps to hold game settings
 struct Settings {
@@ -37,6 +48,12 @@ struct Settings {
         int yTiles;
 
         sf::Time timePerDecision; // Time per decision make
+
+        sf::Time pathfindBudget = sf::milliseconds(2); // Time per frame spent resolving queued path requests
+        float pathVisibleDistance = 160.0f; // Requests closer than this to the player are treated as visible
+        float pathNearDistance = 320.0f; // Requests closer than this to the player are treated as near
+
+        Navigation navigation = Navigation::Grid; // Environment pathfindWaypoints plans on
 };
 
 // Direction represents one of the four cardinal 2D directions
@@ -47,6 +64,28 @@ enum Direction {
     Left
 };
 
+// PathPriority represents how urgently a queued path request should be resolved
+enum PathPriority {
+    Visible,
+    Near,
+    Distant
+};
+
+// PathRequest represents a queued pathfinding request
+struct PathRequest {
+    int ticket;
+    int sequence; // Order the request was queued in, to keep requests of the same priority first come first serve
+    int waiters;  // Number of requesters that still need to collect the result
+    PathPriority priority;
+
+    Vertex<Grid<int>> *startVertex;
+    Vertex<Grid<int>> *endVertex;
+    Heuristic<Grid<int>, int> *heuristic;
+    float epsilon;
+    bool focal;
+    const char *caller;
+};
+
 // Recording represents a given entity that should have their state information recorded to a file
 class Recording {
     public:
@@ -85,11 +124,24 @@ class Engine : public sf::RenderWindow {
         std::vector<Recording*> recordings;
 
         // The player character
-        Entity *playerCharacter;
+        Entity *playerCharacter = nullptr;
 
         // Game environment the engine is running on
         GridEnvironment environment;
 
+        // Obstacles drawn once into an off-screen layer, redrawn only when the obstacle set changes
+        sf::RenderTexture obstacleLayer;
+        sf::Sprite obstacleLayerSprite;
+        bool obstacleLayerStale = true;
+        std::size_t obstacleLayerCount = 0;
+
+        // Navigation mesh over the environment, rebuilt the first time it is needed after a tile is blocked or opened
+        std::unique_ptr<NavMeshEnvironment> navMesh;
+        bool navMeshStale = true;
+
+        // Contraction hierarchy over the layout loaded by loadMap, dropped as soon as a tile is blocked or opened
+        std::unique_ptr<ContractionHierarchy<Grid<int>, int>> hierarchy;
+
         // Variables of the game state
         std::map<std::string, void*> stateVariables;
 
@@ -100,9 +152,33 @@ class Engine : public sf::RenderWindow {
         // Timekeeping incremental varaible
         int timestamp = 0;
 
+        // Pathfinding statistics (only recorded when SEARCH_STATS_ENABLED is defined)
+        SearchStats frameSearchStats;
+        SearchStats lastFrameSearchStats;
+        std::map<std::string, SearchStats> callerSearchStats;
+
+        // Space-time reservations shared by cooperatively pathfinding agents
+        ReservationTable<int> reservations;
+        int cooperativeAgents = 0;
+
+        // Queued path requests and the results that have not been collected yet
+        std::vector<PathRequest> pathRequests;
+        std::map<int, std::vector<Edge<int>*>> pathResults;
+        std::map<int, int> pathResultWaiters;
+        int nextTicket = 0;
+
         // Methods to handle running game
         void handleEvents();
+        void processPathRequests();
+        Vertex<Grid<int>> *quantizeStart(sf::Vector2f position);
+        Vertex<Grid<int>> *quantizeGoal(sf::Vector2f position, Vertex<Grid<int>> *startVertex);
+        int cellOf(Vertex<Grid<int>> *vertex);
+        Vertex<Grid<int>> *vertexOf(int cell);
+        int estimate(Heuristic<Grid<int>, int> *heuristic, int from, int to);
+        void cellsToEdges(int startCell, const std::vector<int> &cells, std::vector<Edge<int>*> *path);
+        std::vector<Edge<int>*> search(Vertex<Grid<int>> *startVertex, Vertex<Grid<int>> *endVertex, Heuristic<Grid<int>, int> *heuristic, const char *caller, float epsilon, bool focal);
         void update(sf::Time dt);
+        void renderObstacleLayer();
         void render();
 
     public:
@@ -119,15 +195,39 @@ class Engine : public sf::RenderWindow {
         int getTimestamp();
         void newEntity(Entity *entity);
         void newObstacle(GridObstacle *obstacle);
+        bool loadMap(std::string filename, const sf::Texture &obstacleTexture);
+        void removeObstacle(GridObstacle *obstacle);
+        void setCellBlocked(int row, int col, bool blocked);
+        void setCellCost(int row, int col, int cost);
         void addRecorder(std::string filepath, Entity* entity);
         void start();
 
         // Methods entities can call
         std::vector<Entity> getClosestEntities(long unsigned int n, Target entity);
         std::vector<Entity> getEntitiesInRadius(float n, Target entity);
-        std::vector<Edge<int>*> pathfind(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic);
+        std::vector<Edge<int>*> pathfind(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, const char *caller = "Engine", float epsilon = 0, bool focal = false);
+        int requestPath(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, PathPriority priority, const char *caller = "Engine", float epsilon = 0, bool focal = false);
+        bool pollPath(int ticket, std::vector<Edge<int>*> *path);
+        void cancelPath(int ticket);
+        PathPriority pathPriority(sf::Vector2f position);
+        bool isReachable(sf::Vector2f currentPosition, sf::Vector2f goalPosition);
+        int newCooperativeAgent();
+        std::vector<Vertex<Grid<int>>*> pathfindCooperative(int agent, sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, int window, const char *caller = "Engine");
+        std::vector<Edge<int>*> pathfindToNearest(sf::Vector2f currentPosition, std::vector<sf::Vector2f> goalPositions, Heuristic<Grid<int>, int> *heuristic, int *reachedGoal, const char *caller = "Engine");
+        std::vector<sf::Vector2f> pathfindWaypoints(sf::Vector2f currentPosition, sf::Vector2f goalPosition, Heuristic<Grid<int>, int> *heuristic, const char *caller = "Engine");
         GridEnvironment *getEnvironment();
+        NavMeshEnvironment *getNavMesh();
         float nearestObstacle(sf::Vector2f position, Direction direction);
+        bool lineOfSight(sf::Vector2f from, sf::Vector2f to);
+        void lineOfSight(const std::vector<Ray> &rays, std::vector<bool> *visible);
+        float raycast(sf::Vector2f from, sf::Vector2f to);
+        void raycast(const std::vector<Ray> &rays, std::vector<float> *distances);
+        bool canSee(sf::Vector2f from, sf::Vector2f to);
+        void canSee(const std::vector<sf::Vector2f> &viewers, sf::Vector2f target, std::vector<bool> *sees);
+
+        // Pathfinding statistics
+        SearchStats getFrameSearchStats();
+        std::map<std::string, SearchStats> *getCallerSearchStats();
 };
 
 
@@ -0,0 +1,398 @@
+#include "chunked-environment.hpp"
+#include <queue>
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+
+/* ChunkedGridEnvironment Class */
+
+// Create a world of rows x cols tiles, streamed from a directory in chunks of chunkSize x chunkSize tiles
+// Chunks that aren't needed for idleFrames calls to update() are evicted
+ChunkedGridEnvironment::ChunkedGridEnvironment(std::string directory, int chunkSize, int rows, int cols, float tileWidth, float tileHeight, int idleFrames) {
+    this->directory = directory;
+    this->chunkSize = chunkSize;
+    this->rows = rows;
+    this->cols = cols;
+    this->tileWidth = tileWidth;
+    this->tileHeight = tileHeight;
+    this->idleFrames = idleFrames;
+
+    this->loader = std::thread(&ChunkedGridEnvironment::runLoader, this);
+}
+
+// Stop the loader and save every chunk that changed
+ChunkedGridEnvironment::~ChunkedGridEnvironment() {
+    {
+        std::lock_guard<std::mutex> guard(this->loaderLock);
+        this->stopping = true;
+    }
+    this->loaderCondition.notify_all();
+    this->loader.join();
+
+    for (std::pair<const int64_t, Chunk*> &entry : this->chunks) {
+        if (entry.second->dirty) {
+            this->writeChunk(entry.second);
+        }
+        delete entry.second;
+    }
+    for (std::pair<int, Chunk*> &result : this->loaded) {
+        delete result.second;
+    }
+}
+
+// Quantize a given environment position to a tile
+Grid<int> ChunkedGridEnvironment::quantize(sf::Vector2f position) {
+    return Grid<int>((int) std::floor(position.y / this->tileHeight), (int) std::floor(position.x / this->tileWidth));
+}
+
+// Localize a tile to the environment position of its center
+sf::Vector2f ChunkedGridEnvironment::localize(Grid<int> tile) {
+    return sf::Vector2f(tile.column * this->tileWidth + this->tileWidth / 2, tile.row * this->tileHeight + this->tileHeight / 2);
+}
+
+// Determine if a tile is an obstacle (tiles outside of the world count as obstacles, and unloaded chunks are loaded right away)
+bool ChunkedGridEnvironment::isObstacle(int row, int col) {
+    if (row < 0 || row >= this->rows || col < 0 || col >= this->cols) {
+        return true;
+    }
+
+    Chunk *chunk = this->getChunk(row, col);
+    return chunk->blocked[(row % this->chunkSize) * this->chunkSize + col % this->chunkSize];
+}
+
+// Block or open a tile (the change is saved when its chunk is evicted)
+void ChunkedGridEnvironment::setCellBlocked(int row, int col, bool blocked) {
+    if (row < 0 || row >= this->rows || col < 0 || col >= this->cols) {
+        return;
+    }
+
+    Chunk *chunk = this->getChunk(row, col);
+    chunk->blocked[(row % this->chunkSize) * this->chunkSize + col % this->chunkSize] = blocked;
+    chunk->dirty = true;
+}
+
+// Ask the loader for a chunk (a chunk that is already loaded is just kept from being evicted)
+void ChunkedGridEnvironment::requestChunk(int chunkRow, int chunkCol) {
+    if (chunkRow < 0 || chunkRow * this->chunkSize >= this->rows || chunkCol < 0 || chunkCol * this->chunkSize >= this->cols) {
+        return;
+    }
+
+    int64_t chunkKey = key(chunkRow, chunkCol);
+    std::unordered_map<int64_t, Chunk*>::iterator it = this->chunks.find(chunkKey);
+    if (it != this->chunks.end()) {
+        it->second->lastUsed = this->frame;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(this->loaderLock);
+        if (this->pending.count(chunkKey) > 0) {
+            return;
+        }
+        this->pending[chunkKey] = this->nextTicket;
+        this->requested.push_back(std::make_pair(chunkKey, this->nextTicket));
+        this->nextTicket++;
+    }
+    this->loaderCondition.notify_one();
+}
+
+// Keep every chunk within a radius (in chunks) of a position loaded, such as around an active entity
+void ChunkedGridEnvironment::keepLoaded(sf::Vector2f position, int radius) {
+    Grid<int> tile = this->quantize(position);
+    int chunkRow = (int) std::floor((float) tile.row / this->chunkSize);
+    int chunkCol = (int) std::floor((float) tile.column / this->chunkSize);
+
+    for (int dRow = -radius; dRow <= radius; dRow++) {
+        for (int dCol = -radius; dCol <= radius; dCol++) {
+            this->requestChunk(chunkRow + dRow, chunkCol + dCol);
+        }
+    }
+}
+
+// Request every chunk a path passes through, in the order it passes through them
+void ChunkedGridEnvironment::prefetchPath(const std::vector<Grid<int>> &path) {
+    int lastChunkRow = -1;
+    int lastChunkCol = -1;
+    for (const Grid<int> &tile : path) {
+        int chunkRow = tile.row / this->chunkSize;
+        int chunkCol = tile.column / this->chunkSize;
+        if (chunkRow != lastChunkRow || chunkCol != lastChunkCol) {
+            this->requestChunk(chunkRow, chunkCol);
+            lastChunkRow = chunkRow;
+            lastChunkCol = chunkCol;
+        }
+    }
+}
+
+// Return true if a chunk is loaded
+bool ChunkedGridEnvironment::isChunkLoaded(int chunkRow, int chunkCol) {
+    return this->chunks.count(key(chunkRow, chunkCol)) > 0;
+}
+
+// Return the number of chunks held in memory
+int ChunkedGridEnvironment::numLoadedChunks() {
+    return this->chunks.size();
+}
+
+// Install the chunks the loader has finished and evict the ones that have sat idle (call once per frame)
+void ChunkedGridEnvironment::update() {
+    this->frame++;
+    this->installLoaded();
+
+    for (std::unordered_map<int64_t, Chunk*>::iterator it = this->chunks.begin(); it != this->chunks.end();) {
+        if (this->frame - it->second->lastUsed <= this->idleFrames) {
+            it++;
+            continue;
+        }
+
+        if (it->second->dirty) {
+            this->writeChunk(it->second);
+        }
+        delete it->second;
+        it = this->chunks.erase(it);
+    }
+}
+
+// Find the shortest 4-connected path between two positions without blocking on disk
+// The search only walks loaded chunks. Unloaded chunks it reaches are requested from the loader, and if any of them could
+// hold a shorter path the result is Loading, so call update() and search again later. Chunks the search doesn't touch are
+// still evicted as usual (maxExpansions bounds the search, 0 for no bound). The path holds every tile from start to end.
+ChunkPathStatus ChunkedGridEnvironment::findPath(sf::Vector2f from, sf::Vector2f to, std::vector<Grid<int>> *path, int maxExpansions) {
+    Grid<int> start = this->quantize(from);
+    Grid<int> end = this->quantize(to);
+    if (start.row < 0 || start.row >= this->rows || start.column < 0 || start.column >= this->cols ||
+            end.row < 0 || end.row >= this->rows || end.column < 0 || end.column >= this->cols) {
+        return ChunkPathStatus::NoPath;
+    }
+
+    // Both ends have to be loaded before anything can be searched
+    Chunk *startChunk = this->findChunk(start.row, start.column);
+    Chunk *endChunk = this->findChunk(end.row, end.column);
+    if (startChunk == nullptr || endChunk == nullptr) {
+        this->requestChunk(start.row / this->chunkSize, start.column / this->chunkSize);
+        this->requestChunk(end.row / this->chunkSize, end.column / this->chunkSize);
+        return ChunkPathStatus::Loading;
+    }
+    if (startChunk->blocked[(start.row % this->chunkSize) * this->chunkSize + start.column % this->chunkSize] ||
+            endChunk->blocked[(end.row % this->chunkSize) * this->chunkSize + end.column % this->chunkSize]) {
+        return ChunkPathStatus::NoPath;
+    }
+
+    // Tiles are keyed by their row-major index, so the world never needs a dense array
+    struct Record {
+        int64_t parent;
+        int costSoFar;
+        bool closed;
+    };
+    std::unordered_map<int64_t, Record> records;
+    std::priority_queue<std::pair<int, int64_t>, std::vector<std::pair<int, int64_t>>, std::greater<std::pair<int, int64_t>>> openList;
+
+    int64_t startKey = (int64_t) start.row * this->cols + start.column;
+    int64_t endKey = (int64_t) end.row * this->cols + end.column;
+    records[startKey] = {-1, 0, false};
+    openList.push(std::make_pair(std::abs(start.row - end.row) + std::abs(start.column - end.column), startKey));
+
+    int dRow[] = {-1, 0, 0, 1};
+    int dCol[] = {0, -1, 1, 0};
+    int expansions = 0;
+    bool found = false;
+    bool exhausted = false;
+
+    // The lowest estimated cost through a tile in an unloaded chunk, which no path through those chunks can beat
+    int deferredCost = std::numeric_limits<int>::max();
+
+    while (openList.size() > 0) {
+        int64_t current = openList.top().second;
+        openList.pop();
+
+        Record &record = records.at(current);
+        if (record.closed) {
+            continue;
+        }
+        record.closed = true;
+
+        if (current == endKey) {
+            found = true;
+            break;
+        }
+        if (maxExpansions > 0 && ++expansions > maxExpansions) {
+            exhausted = true;
+            break;
+        }
+
+        int row = current / this->cols;
+        int col = current % this->cols;
+        int costSoFar = record.costSoFar;
+        for (int d = 0; d < 4; d++) {
+            int r = row + dRow[d];
+            int c = col + dCol[d];
+            if (r < 0 || r >= this->rows || c < 0 || c >= this->cols) {
+                continue;
+            }
+
+            int estimate = costSoFar + 1 + std::abs(r - end.row) + std::abs(c - end.column);
+            Chunk *chunk = this->findChunk(r, c);
+            if (chunk == nullptr) {
+                this->requestChunk(r / this->chunkSize, c / this->chunkSize);
+                deferredCost = std::min(deferredCost, estimate);
+                continue;
+            }
+            if (chunk->blocked[(r % this->chunkSize) * this->chunkSize + c % this->chunkSize]) {
+                continue;
+            }
+
+            int64_t next = (int64_t) r * this->cols + c;
+            std::unordered_map<int64_t, Record>::iterator it = records.find(next);
+            if (it != records.end() && it->second.costSoFar <= costSoFar + 1) {
+                continue;
+            }
+
+            records[next] = {current, costSoFar + 1, false};
+            openList.push(std::make_pair(estimate, next));
+        }
+    }
+
+    // A path found around unloaded chunks only counts if none of them could have held a shorter one
+    if (found && deferredCost < records.at(endKey).costSoFar) {
+        return ChunkPathStatus::Loading;
+    }
+    if (!found) {
+        return exhausted || deferredCost == std::numeric_limits<int>::max() ? ChunkPathStatus::NoPath : ChunkPathStatus::Loading;
+    }
+
+    // Compile the tiles back from the end, then reverse them
+    for (int64_t tile = endKey; tile != -1; tile = records.at(tile).parent) {
+        path->push_back(Grid<int>(tile / this->cols, tile % this->cols));
+    }
+    std::reverse(std::begin(*path), std::end(*path));
+
+    // Start streaming in everything the path crosses
+    this->prefetchPath(*path);
+    return ChunkPathStatus::Found;
+}
+
+// Combine a chunk's coordinates into a single key
+int64_t ChunkedGridEnvironment::key(int chunkRow, int chunkCol) {
+    return ((int64_t) chunkRow << 32) | (uint32_t) chunkCol;
+}
+
+// Get the file a chunk is stored in
+std::string ChunkedGridEnvironment::chunkFilename(int chunkRow, int chunkCol) {
+    return this->directory + "/" + std::to_string(chunkRow) + "_" + std::to_string(chunkCol) + ".chunk";
+}
+
+// Read a chunk from disk (safe to call from the loader thread)
+Chunk *ChunkedGridEnvironment::readChunk(int chunkRow, int chunkCol) {
+    Chunk *chunk = new Chunk();
+    chunk->chunkRow = chunkRow;
+    chunk->chunkCol = chunkCol;
+    chunk->blocked = std::vector<bool>(this->chunkSize * this->chunkSize, false);
+
+    std::ifstream file(this->chunkFilename(chunkRow, chunkCol));
+    std::string line;
+    for (int row = 0; row < this->chunkSize && std::getline(file, line); row++) {
+        for (int col = 0; col < this->chunkSize && col < (int) line.size(); col++) {
+            chunk->blocked[row * this->chunkSize + col] = line.at(col) == 'x';
+        }
+    }
+
+    return chunk;
+}
+
+// Write a chunk back to disk
+void ChunkedGridEnvironment::writeChunk(Chunk *chunk) {
+    std::ofstream file(this->chunkFilename(chunk->chunkRow, chunk->chunkCol));
+    for (int row = 0; row < this->chunkSize; row++) {
+        for (int col = 0; col < this->chunkSize; col++) {
+            file << (chunk->blocked[row * this->chunkSize + col] ? 'x' : '.');
+        }
+        file << "\n";
+    }
+    chunk->dirty = false;
+}
+
+// Load requested chunks in the background until the environment is destroyed
+void ChunkedGridEnvironment::runLoader() {
+    while (true) {
+        std::pair<int64_t, int> request;
+        {
+            std::unique_lock<std::mutex> guard(this->loaderLock);
+            this->loaderCondition.wait(guard, [this] { return this->stopping || this->requested.size() > 0; });
+            if (this->stopping) {
+                return;
+            }
+
+            request = this->requested.front();
+            this->requested.pop_front();
+        }
+
+        Chunk *chunk = this->readChunk(request.first >> 32, (int32_t) (request.first & 0xffffffff));
+
+        std::lock_guard<std::mutex> guard(this->loaderLock);
+        this->loaded.push_back(std::make_pair(request.second, chunk));
+    }
+}
+
+// Get the chunk holding a tile if it's loaded, or nullptr if it isn't
+Chunk *ChunkedGridEnvironment::findChunk(int row, int col) {
+    std::unordered_map<int64_t, Chunk*>::iterator it = this->chunks.find(key(row / this->chunkSize, col / this->chunkSize));
+    if (it == this->chunks.end()) {
+        return nullptr;
+    }
+    it->second->lastUsed = this->frame;
+    return it->second;
+}
+
+// Get the chunk holding a tile, reading it right away if it isn't loaded yet
+Chunk *ChunkedGridEnvironment::getChunk(int row, int col) {
+    Chunk *loadedChunk = this->findChunk(row, col);
+    if (loadedChunk != nullptr) {
+        return loadedChunk;
+    }
+
+    int chunkRow = row / this->chunkSize;
+    int chunkCol = col / this->chunkSize;
+    int64_t chunkKey = key(chunkRow, chunkCol);
+
+    // Whatever the loader is still reading for this chunk is now out of date
+    {
+        std::lock_guard<std::mutex> guard(this->loaderLock);
+        this->pending.erase(chunkKey);
+    }
+
+    Chunk *chunk = this->readChunk(chunkRow, chunkCol);
+    chunk->lastUsed = this->frame;
+    this->chunks[chunkKey] = chunk;
+    return chunk;
+}
+
+// Move the loader's finished chunks into the world (dropping loads that were read again or evicted since they were requested)
+void ChunkedGridEnvironment::installLoaded() {
+    std::vector<std::pair<int, Chunk*>> results;
+    {
+        std::lock_guard<std::mutex> guard(this->loaderLock);
+        results.swap(this->loaded);
+
+        for (std::vector<std::pair<int, Chunk*>>::iterator it = results.begin(); it != results.end(); it++) {
+            int64_t chunkKey = key(it->second->chunkRow, it->second->chunkCol);
+            std::unordered_map<int64_t, int>::iterator request = this->pending.find(chunkKey);
+            if (request == this->pending.end() || request->second != it->first) {
+                delete it->second;
+                it->second = nullptr;
+                continue;
+            }
+            this->pending.erase(request);
+        }
+    }
+
+    for (std::pair<int, Chunk*> &result : results) {
+        if (result.second == nullptr) {
+            continue;
+        }
+
+        result.second->lastUsed = this->frame;
+        this->chunks[key(result.second->chunkRow, result.second->chunkCol)] = result.second;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef CHUNKED_ENVIRONMENT
+#define CHUNKED_ENVIRONMENT
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+#include "../utils/graph/vertex.hpp"
+
+// Chunk represents a square block of tiles that is loaded and evicted as a unit
+struct Chunk {
+    int chunkRow;
+    int chunkCol;
+    std::vector<bool> blocked; // Row-major obstacle bitmap of the chunk's tiles
+    int lastUsed = 0;          // Frame the chunk was last needed on
+    bool dirty = false;        // True if the chunk changed since it was loaded and must be saved before eviction
+};
+
+// ChunkPathStatus is the outcome of a search across chunks
+enum class ChunkPathStatus {
+    Found,   // The path was found
+    NoPath,  // The end can't be reached from the start (or not within the expansion bound)
+    Loading  // The search needs chunks that aren't loaded yet, which have been requested (search again once update installs them)
+};
+
+// ChunkedGridEnvironment represents a grid world too large to hold at once, streamed in fixed-size chunks
+//
+// Chunks are read from "<directory>/<chunkRow>_<chunkCol>.chunk" (one line per row of tiles, 'x' for obstacles
+// and anything else for open tiles). A missing file is an open chunk. A background thread loads requested chunks,
+// and update() installs them and evicts the ones that have sat idle.
+class ChunkedGridEnvironment {
+    private:
+        std::string directory;
+        int chunkSize;
+        int rows;
+        int cols;
+        float tileWidth;
+        float tileHeight;
+        int idleFrames;
+
+        int frame = 0;
+        std::unordered_map<int64_t, Chunk*> chunks;
+
+        // Requests and results shared with the loader thread
+        std::mutex loaderLock;
+        std::condition_variable loaderCondition;
+        std::deque<std::pair<int64_t, int>> requested; // Chunk key and ticket of each queued load
+        std::unordered_map<int64_t, int> pending;       // Ticket of the load each requested chunk is waiting on
+        std::vector<std::pair<int, Chunk*>> loaded;     // Finished loads and the tickets they were made for
+        int nextTicket = 0;
+        bool stopping = false;
+        std::thread loader;
+
+        static int64_t key(int chunkRow, int chunkCol);
+        std::string chunkFilename(int chunkRow, int chunkCol);
+        Chunk *readChunk(int chunkRow, int chunkCol);
+        void writeChunk(Chunk *chunk);
+        void runLoader();
+        Chunk *findChunk(int row, int col);
+        Chunk *getChunk(int row, int col);
+        void installLoaded();
+
+    public:
+        ChunkedGridEnvironment(std::string directory, int chunkSize, int rows, int cols, float tileWidth, float tileHeight, int idleFrames = 300);
+        ~ChunkedGridEnvironment();
+
+        Grid<int> quantize(sf::Vector2f position);
+        sf::Vector2f localize(Grid<int> tile);
+
+        bool isObstacle(int row, int col);
+        void setCellBlocked(int row, int col, bool blocked);
+
+        void requestChunk(int chunkRow, int chunkCol);
+        void keepLoaded(sf::Vector2f position, int radius);
+        void prefetchPath(const std::vector<Grid<int>> &path);
+        bool isChunkLoaded(int chunkRow, int chunkCol);
+        int numLoadedChunks();
+        void update();
+
+        ChunkPathStatus findPath(sf::Vector2f from, sf::Vector2f to, std::vector<Grid<int>> *path, int maxExpansions = 0);
+};
+
+#endif
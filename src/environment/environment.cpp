@@ -1,4 +1,11 @@
 #include "environment.hpp"
+#include <deque>
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <algorithm>
 #include "../engine/engine.hpp"
 
 /* GridObstacle Class */
@@ -15,6 +22,10 @@ Grid<int> GridObstacle::getGridLocation() {
 
 /* GridEnvironment Class */
 
+// Offsets to each tile's neighbours, in the order their edges are kept (up, left, right, down), so neighbor 3 - d is the way back
+static const int neighborRow[] = {-1, 0, 0, 1};
+static const int neighborCol[] = {0, -1, 1, 0};
+
 // Generate a new Grid Environment that is split into a given number of tiles
 GridEnvironment::GridEnvironment(int xTiles, int yTiles, int width, int height) {
     // Get information about each tile in the grid
@@ -26,44 +37,95 @@ GridEnvironment::GridEnvironment(int xTiles, int yTiles, int width, int height)
     this->tileWidth = width / xTiles;
     this->tileHeight = height / yTiles;
 
-    // Create a graph representing all vertices in the grid
-    this->setGraph(AdjacencyListGraph<Grid<int>, int>(true));
+    // The adjacency list graph is only built once a vertex or edge is asked for
+    this->gridGraph = ImplicitGridGraph<int>(yTiles, xTiles, 1);
+
+    // Every tile starts out in the same connected component
+    this->componentLabels = std::vector<int>(xTiles * yTiles, 0);
+    this->componentScratch = std::vector<int>(xTiles * yTiles, -1);
+    this->nextComponent = 1;
+
+    // Measure how far every tile is from the edges of the grid
+    this->stepsUp = std::vector<int>(xTiles * yTiles);
+    this->stepsDown = std::vector<int>(xTiles * yTiles);
+    this->stepsLeft = std::vector<int>(xTiles * yTiles);
+    this->stepsRight = std::vector<int>(xTiles * yTiles);
     for (int row = 0; row < yTiles; row++) {
-        for (int col = 0; col < xTiles; col++) {
-            this->getGraph()->insertVertex(Grid(row, col));
+        this->updateRowSteps(row);
+    }
+    for (int col = 0; col < xTiles; col++) {
+        this->updateColumnSteps(col);
+    }
+
+    // Every tile starts out open
+    this->wordsPerRow = (xTiles + 63) / 64;
+    this->packedRows = std::vector<uint64_t>(this->wordsPerRow * yTiles, 0);
+}
+
+// Build the adjacency list graph of the grid, with a vertex per tile and an edge to each neighbouring tile (blocked tiles are kept out of it)
+void GridEnvironment::buildGraph() {
+    if (this->graphBuilt) {
+        return;
+    }
+    this->graphBuilt = true;
+
+    this->setGraph(AdjacencyListGraph<Grid<int>, int>(true));
+    AdjacencyListGraph<Grid<int>, int> *graph = this->getGraph();
+
+    this->tileVertices.reserve(this->xTiles * this->yTiles);
+    this->cells.reserve(this->xTiles * this->yTiles);
+    for (int row = 0; row < this->yTiles; row++) {
+        for (int col = 0; col < this->xTiles; col++) {
+            this->tileVertices.push_back(graph->insertVertex(Grid(row, col)));
+            this->cells.push_back(this->isObstacle(row, col) ? nullptr : this->tileVertices.back());
         }
     }
 
-    // Add edges between vertices in the grid
-    for (Vertex<Grid<int>> *v : this->getGraph()->vertices()) {
-        Grid<int> grid = v->getElement();
-        for (Vertex<Grid<int>> *connecting : this->getGraph()->vertices()) {
-            Grid<int> connectingGrid = connecting->getElement();
-            if ((grid.row - 1 == connectingGrid.row || grid.row + 1 == connectingGrid.row) && grid.column == connectingGrid.column) {
-                this->getGraph()->insertEdge(v, connecting, 1);
-            } else if ((grid.column - 1 == connectingGrid.column || grid.column + 1 == connectingGrid.column) && grid.row == connectingGrid.row) {
-                this->getGraph()->insertEdge(v, connecting, 1);
+    // Add edges between each tile and its neighbours, costing whatever it costs to move into the neighbour
+    this->tileEdges = std::vector<std::array<Edge<int>*, 4>>(this->xTiles * this->yTiles);
+    for (int v = 0; v < this->xTiles * this->yTiles; v++) {
+        for (int d = 0; d < 4; d++) {
+            int row = v / this->xTiles + neighborRow[d];
+            int col = v % this->xTiles + neighborCol[d];
+            if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles) {
+                this->tileEdges[v][d] = nullptr;
+                continue;
             }
-        } 
+            this->tileEdges[v][d] = graph->insertEdge(this->tileVertices[v], this->tileVertices[row * this->xTiles + col], this->gridGraph.getCost(row, col));
+        }
     }
-}
 
-// Quantize a given environment position to a vertex on the graph (specifically for grid environments)
-Vertex<Grid<int>> *GridEnvironment::quantize(sf::Vector2f position) {
-    // Get the row and column of the position
-    int column = position.x / this->tileWidth;
-    int row = position.y / this->tileHeight;
+    if (std::find(this->cells.begin(), this->cells.end(), nullptr) != this->cells.end()) {
+        this->attachOpenTiles();
+    }
+    this->invalidateGraph();
+}
 
-    // Find the associated vertex
-    Grid<int> element;
-    for (Vertex<Grid<int>> *v : this->getGraph()->vertices()) {
-        element = v->getElement();
-        if (element.row == row && element.column == column) {
-            return v;
+// Refill the graph in the order buildGraph built it, leaving out blocked tiles and their edges
+void GridEnvironment::attachOpenTiles() {
+    AdjacencyListGraph<Grid<int>, int> *graph = this->getGraph();
+    graph->detachAll();
+    for (int index = 0; index < this->xTiles * this->yTiles; index++) {
+        if (this->cells[index] != nullptr) {
+            graph->attachVertex(this->cells[index]);
         }
     }
+    for (int index = 0; index < this->xTiles * this->yTiles; index++) {
+        if (this->cells[index] == nullptr) {
+            continue;
+        }
+        for (int d = 0; d < 4; d++) {
+            if (this->tileEdges[index][d] != nullptr && this->cells[index + neighborRow[d] * this->xTiles + neighborCol[d]] != nullptr) {
+                graph->attachEdge(this->tileEdges[index][d]);
+            }
+        }
+    }
+}
 
-    return nullptr;
+// Quantize a given environment position to a vertex on the graph (specifically for grid environments)
+Vertex<Grid<int>> *GridEnvironment::quantize(sf::Vector2f position) {
+    // Get the row and column of the position, then look up the associated vertex
+    return this->getVertex((int) (position.y / this->tileHeight), (int) (position.x / this->tileWidth));
 }
 
 // Localize a given vertex to an environment position (specifically for grid environments)
@@ -83,28 +145,397 @@ void GridEnvironment::addObstacle(GridObstacle *gridObstacle) {
     this->getObstacles()->push_back(gridObstacle);
     gridObstacle->setPosition(gridObstacle->getGridLocation().column * (this->width / this->xTiles), gridObstacle->getGridLocation().row * (this->height / this->yTiles));
 
-    // Remove the vertex that overlaps with the graph
-    Grid<int> element;
-    for (Vertex<Grid<int>> *v : this->getGraph()->vertices()) {
-        element = v->getElement();
-        if (element.row == gridObstacle->getGridLocation().row && element.column == gridObstacle->getGridLocation().column) {
-            this->getGraph()->removeVertex(v);
-            break;
+    this->setCellBlocked(gridObstacle->getGridLocation().row, gridObstacle->getGridLocation().column, true);
+}
+
+// Add many grid obstacles at once, blocking all of their tiles in a single pass over the grid
+void GridEnvironment::addObstacles(const std::vector<GridObstacle*> &gridObstacles) {
+    std::vector<bool> blocked(this->xTiles * this->yTiles);
+    for (int i = 0; i < this->xTiles * this->yTiles; i++) {
+        blocked[i] = this->isObstacle(i / this->xTiles, i % this->xTiles);
+    }
+
+    for (GridObstacle *gridObstacle : gridObstacles) {
+        Grid<int> location = gridObstacle->getGridLocation();
+        this->getObstacles()->push_back(gridObstacle);
+        gridObstacle->setPosition(location.column * (this->width / this->xTiles), location.row * (this->height / this->yTiles));
+
+        if (location.row >= 0 && location.row < this->yTiles && location.column >= 0 && location.column < this->xTiles) {
+            blocked[location.row * this->xTiles + location.column] = true;
+        }
+    }
+
+    this->setObstacleLayout(blocked);
+}
+
+// Remove a grid obstacle from the environment, opening its tile unless another obstacle covers it (the obstacle isn't deleted)
+void GridEnvironment::removeObstacle(GridObstacle *gridObstacle) {
+    std::vector<Obstacle*> *obstacles = this->getObstacles();
+    std::vector<Obstacle*>::iterator it = std::find(obstacles->begin(), obstacles->end(), gridObstacle);
+    if (it == obstacles->end()) {
+        return;
+    }
+    obstacles->erase(it);
+
+    Grid<int> location = gridObstacle->getGridLocation();
+    for (Obstacle *obstacle : *obstacles) {
+        GridObstacle *other = dynamic_cast<GridObstacle*>(obstacle);
+        if (other != nullptr && other->getGridLocation().row == location.row && other->getGridLocation().column == location.column) {
+            return;
+        }
+    }
+
+    this->setCellBlocked(location.row, location.column, false);
+}
+
+// Set the cost of moving into a tile, on both the implicit grid and the graph edges that lead into it
+void GridEnvironment::setCellCost(int row, int col, int cost) {
+    if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles) {
+        return;
+    }
+
+    int index = row * this->xTiles + col;
+    this->gridGraph.setCost(row, col, cost);
+    if (this->graphBuilt) {
+        for (int d = 0; d < 4; d++) {
+            if (this->tileEdges[index][d] != nullptr) {
+                this->tileEdges[index + neighborRow[d] * this->xTiles + neighborCol[d]][3 - d]->setElement(cost);
+            }
+        }
+        this->invalidateGraph();
+    }
+}
+
+// Block or open a tile in place, repairing everything built from the obstacle layout around it
+void GridEnvironment::setCellBlocked(int row, int col, bool blocked) {
+    if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles || this->isObstacle(row, col) == blocked) {
+        return;
+    }
+
+    int index = row * this->xTiles + col;
+
+    if (blocked) {
+        // Split the connected component the tile was part of
+        int label = this->componentLabels.at(index);
+        this->componentLabels.at(index) = -1;
+        this->splitComponent(row, col, label);
+
+        // Take the tile's vertex and edges out of the graph, keeping them so paths that hold them stay valid
+        if (this->graphBuilt) {
+            this->getGraph()->detachVertex(this->tileVertices[index]);
+            this->cells[index] = nullptr;
+            this->invalidateGraph();
+        }
+        this->gridGraph.setBlocked(row, col, true);
+        this->packedRows.at(row * this->wordsPerRow + col / 64) |= (uint64_t) 1 << (col % 64);
+    } else {
+        this->gridGraph.setBlocked(row, col, false);
+        this->packedRows.at(row * this->wordsPerRow + col / 64) &= ~((uint64_t) 1 << (col % 64));
+
+        // Put the tile's vertex and its edges to open neighbours back into the graph
+        if (this->graphBuilt) {
+            this->getGraph()->attachVertex(this->tileVertices[index]);
+            this->cells[index] = this->tileVertices[index];
+
+            for (int d = 0; d < 4; d++) {
+                int neighbor = index + neighborRow[d] * this->xTiles + neighborCol[d];
+                if (this->tileEdges[index][d] != nullptr && this->cells[neighbor] != nullptr) {
+                    this->getGraph()->attachEdge(this->tileEdges[index][d]);
+                    this->getGraph()->attachEdge(this->tileEdges[neighbor][3 - d]);
+                }
+            }
+
+            // Keep every edge list in the order buildGraph built it, so searches break ties the same way
+            this->orderEdges(index);
+            for (int d = 0; d < 4; d++) {
+                if (this->tileEdges[index][d] != nullptr && this->cells[index + neighborRow[d] * this->xTiles + neighborCol[d]] != nullptr) {
+                    this->orderEdges(index + neighborRow[d] * this->xTiles + neighborCol[d]);
+                }
+            }
+            this->invalidateGraph();
         }
+
+        this->mergeComponents(row, col);
+    }
+
+    // Only the tile's row and column can change distance to an obstacle in a straight line
+    this->updateRowSteps(row);
+    this->updateColumnSteps(col);
+    this->obstacleDistancesStale = true;
+
+    // Patch the lines of sight the tile cuts or clears
+    if (this->isVisibilityBuilt()) {
+        this->updateVisibility(row, col);
+    }
+
+    for (std::function<void(int, int, bool)> &listener : this->cellListeners) {
+        listener(row, col, blocked);
     }
 }
 
-// Determine if a given grid element is an obstacle
+// Replace the whole obstacle layout (a row-major list of blocked tiles), rebuilding everything built from it in one pass
+// Cheaper than calling setCellBlocked per tile when many tiles change at once, such as when a level is loaded
+void GridEnvironment::setObstacleLayout(const std::vector<bool> &blocked) {
+    std::vector<int> changed;
+    for (int index = 0; index < this->xTiles * this->yTiles; index++) {
+        int row = index / this->xTiles;
+        int col = index % this->xTiles;
+        if (blocked.at(index) == this->isObstacle(row, col)) {
+            continue;
+        }
+        changed.push_back(index);
+
+        this->gridGraph.setBlocked(row, col, blocked.at(index));
+        if (blocked.at(index)) {
+            this->packedRows.at(row * this->wordsPerRow + col / 64) |= (uint64_t) 1 << (col % 64);
+        } else {
+            this->packedRows.at(row * this->wordsPerRow + col / 64) &= ~((uint64_t) 1 << (col % 64));
+        }
+        if (this->graphBuilt) {
+            this->cells[index] = blocked.at(index) ? nullptr : this->tileVertices[index];
+        }
+    }
+
+    if (changed.size() == 0) {
+        return;
+    }
+
+    if (this->graphBuilt) {
+        this->attachOpenTiles();
+        this->invalidateGraph();
+    }
+
+    this->labelComponents();
+
+    for (int row = 0; row < this->yTiles; row++) {
+        this->updateRowSteps(row);
+    }
+    for (int col = 0; col < this->xTiles; col++) {
+        this->updateColumnSteps(col);
+    }
+    this->obstacleDistancesStale = true;
+
+    if (this->isVisibilityBuilt()) {
+        this->buildVisibility();
+    }
+
+    for (int index : changed) {
+        for (std::function<void(int, int, bool)> &listener : this->cellListeners) {
+            listener(index / this->xTiles, index % this->xTiles, blocked.at(index));
+        }
+    }
+}
+
+// Call a function whenever a tile is blocked or opened (after the environment has repaired itself)
+void GridEnvironment::addCellListener(std::function<void(int, int, bool)> listener) {
+    this->cellListeners.push_back(listener);
+}
+
+// Determine if a given grid element is an obstacle (tiles outside of the grid count as obstacles)
 bool GridEnvironment::isObstacle(int row, int col) {
-    Grid<int> element;
-    for (Vertex<Grid<int>> *v : this->getGraph()->vertices()) {
-        element = v->getElement();
-        if (element.row == row && element.column == col) {
-            return false;
+    return this->gridGraph.isBlocked(row, col);
+}
+
+// Get the number of tiles stepped from a tile in a direction (dRow, dCol) until reaching an obstacle or the edge of the grid
+int GridEnvironment::obstacleSteps(int row, int col, int dRow, int dCol) {
+    int index = row * this->xTiles + col;
+    if (dRow < 0) {
+        return this->stepsUp.at(index);
+    } else if (dRow > 0) {
+        return this->stepsDown.at(index);
+    } else if (dCol < 0) {
+        return this->stepsLeft.at(index);
+    }
+    return this->stepsRight.at(index);
+}
+
+// Get the straight line distance in tiles from a tile to the nearest obstacle (very large if there are none)
+float GridEnvironment::obstacleDistance(int row, int col) {
+    if (this->obstacleDistancesStale) {
+        this->updateObstacleDistances();
+    }
+
+    return this->obstacleDistances.at(row * this->xTiles + col);
+}
+
+// Return true if the straight line between two positions crosses no obstacle tiles
+bool GridEnvironment::lineOfSight(sf::Vector2f from, sf::Vector2f to) {
+    // Always cast from the same end, so lines grazing a corner get the same answer both ways
+    if (to.y < from.y || (to.y == from.y && to.x < from.x)) {
+        std::swap(from, to);
+    }
+
+    float length = std::hypot(to.x - from.x, to.y - from.y);
+    return this->raycast(from, to) >= length;
+}
+
+// Answer a batch of line of sight queries
+void GridEnvironment::lineOfSight(const std::vector<Ray> &rays, std::vector<bool> *visible) {
+    visible->resize(rays.size());
+    for (std::vector<Ray>::size_type i = 0; i < rays.size(); i++) {
+        (*visible)[i] = this->lineOfSight(rays[i].from, rays[i].to);
+    }
+}
+
+// Get the distance from one position towards another until the line enters an obstacle tile or leaves the grid
+// (the full length if it does neither). Tiles the line only touches at a corner count as crossed.
+float GridEnvironment::raycast(sf::Vector2f from, sf::Vector2f to) {
+    // Work in tile coordinates, where tile (row, col) covers [col, col + 1) x [row, row + 1)
+    // (in double precision, so lines passing near a tile corner are not rounded onto it)
+    double x0 = (double) from.x / this->tileWidth;
+    double y0 = (double) from.y / this->tileHeight;
+    double dx = (double) to.x / this->tileWidth - x0;
+    double dy = (double) to.y / this->tileHeight - y0;
+    float length = std::hypot(to.x - from.x, to.y - from.y);
+
+    if (x0 < 0 || x0 >= this->xTiles || y0 < 0 || y0 >= this->yTiles) {
+        return 0;
+    }
+
+    // Walk the rows the line crosses in the order it crosses them, checking the run of columns it covers in each
+    int rowStep = dy >= 0 ? 1 : -1;
+    int lastRow = (int) std::floor(y0 + dy);
+    for (int row = (int) std::floor(y0);; row += rowStep) {
+        // Find the part of the line inside this row
+        double tStart = 0;
+        double tEnd = 1;
+        if (dy != 0) {
+            tStart = std::max(0.0, ((dy > 0 ? row : row + 1) - y0) / dy);
+            tEnd = std::min(1.0, ((dy > 0 ? row + 1 : row) - y0) / dy);
         }
+
+        if (row < 0 || row >= this->yTiles) {
+            return tStart * length;
+        }
+
+        double xa = x0 + tStart * dx;
+        double xb = x0 + tEnd * dx;
+        int colStart = (int) std::floor(std::min(xa, xb));
+        int colEnd = (int) std::floor(std::max(xa, xb));
+
+        int col;
+        if (this->firstBlocked(row, colStart, colEnd, dx >= 0, &col)) {
+            // The line enters the blocked tile when it has crossed into both its row and its column
+            double tCol = 0;
+            if (dx > 0) {
+                tCol = (col - x0) / dx;
+            } else if (dx < 0) {
+                tCol = (col + 1 - x0) / dx;
+            }
+            return std::max(tStart, tCol) * length;
+        }
+
+        if (row == lastRow) {
+            break;
+        }
+    }
+
+    return length;
+}
+
+// Answer a batch of raycasts
+void GridEnvironment::raycast(const std::vector<Ray> &rays, std::vector<float> *distances) {
+    distances->resize(rays.size());
+    for (std::vector<Ray>::size_type i = 0; i < rays.size(); i++) {
+        (*distances)[i] = this->raycast(rays[i].from, rays[i].to);
+    }
+}
+
+// Precompute which tiles can see each other, center to center, across a number of threads (0 uses every hardware thread)
+void GridEnvironment::buildVisibility(unsigned int threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    int tiles = this->xTiles * this->yTiles;
+    this->visibilityWords = (tiles + 63) / 64;
+    this->visibility = std::vector<uint64_t>((std::size_t) tiles * this->visibilityWords, 0);
+
+    // Each worker fills in the upper triangle of the next unbuilt tile's row
+    std::atomic<int> nextTile(0);
+    std::function<void()> worker = [this, tiles, &nextTile]() {
+        for (int from = nextTile++; from < tiles; from = nextTile++) {
+            if (this->isObstacle(from / this->xTiles, from % this->xTiles)) {
+                continue;
+            }
+
+            uint64_t *bits = &this->visibility[(std::size_t) from * this->visibilityWords];
+            bits[from / 64] |= (uint64_t) 1 << (from % 64);
+            for (int to = from + 1; to < tiles; to++) {
+                if (!this->isObstacle(to / this->xTiles, to % this->xTiles) && this->tilesSeeEachOther(from, to)) {
+                    bits[to / 64] |= (uint64_t) 1 << (to % 64);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads && (int) i < tiles; i++) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+
+    for (std::thread &t : workers) {
+        t.join();
+    }
+
+    // Visibility is symmetric, so mirror the upper triangle into the lower one
+    for (int from = 0; from < tiles; from++) {
+        for (int to = 0; to < from; to++) {
+            if ((this->visibility[(std::size_t) to * this->visibilityWords + from / 64] >> (from % 64)) & 1) {
+                this->visibility[(std::size_t) from * this->visibilityWords + to / 64] |= (uint64_t) 1 << (to % 64);
+            }
+        }
+    }
+}
+
+// Return true if the visibility between tiles has been precomputed
+bool GridEnvironment::isVisibilityBuilt() {
+    return this->visibility.size() > 0;
+}
+
+// Return true if the center of one tile can see the center of another (a bit test once visibility is precomputed)
+bool GridEnvironment::isVisible(int row, int col, int toRow, int toCol) {
+    if (this->isObstacle(row, col) || this->isObstacle(toRow, toCol)) {
+        return false;
+    }
+
+    int from = row * this->xTiles + col;
+    int to = toRow * this->xTiles + toCol;
+    if (!this->isVisibilityBuilt()) {
+        return this->tilesSeeEachOther(from, to);
+    }
+
+    return (this->visibility[(std::size_t) from * this->visibilityWords + to / 64] >> (to % 64)) & 1;
+}
+
+// Get the implicit copy of the grid (block tiles and change costs through the environment, so its graph follows)
+ImplicitGridGraph<int> *GridEnvironment::getGridGraph() {
+    return &this->gridGraph;
+}
+
+// Get the vertex of a tile (or nullptr if it is an obstacle or outside of the grid)
+Vertex<Grid<int>> *GridEnvironment::getVertex(int row, int col) {
+    if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles) {
+        return nullptr;
+    }
+
+    this->buildGraph();
+    return this->cells[row * this->xTiles + col];
+}
+
+// Get the edge from one tile to a neighbouring tile (or nullptr if either tile is blocked or they aren't neighbours)
+Edge<int> *GridEnvironment::getEdge(int row, int col, int toRow, int toCol) {
+    if (this->getVertex(row, col) == nullptr || this->getVertex(toRow, toCol) == nullptr) {
+        return nullptr;
     }
 
-    return true;
+    for (int d = 0; d < 4; d++) {
+        if (row + neighborRow[d] == toRow && col + neighborCol[d] == toCol) {
+            return this->tileEdges[row * this->xTiles + col][d];
+        }
+    }
+    return nullptr;
 }
 
 // Localize a given vertex endpoint
@@ -116,4 +547,489 @@ sf::Vector2f GridEnvironment::localizeEndpoint(Edge<int> *edge, int index) {
     }
 
     return this->localize(edges[index]);
-}
\ No newline at end of file
+}
+
+// Get the connected component a tile is part of (-1 for obstacles and tiles off of the grid)
+int GridEnvironment::getComponent(int row, int col) {
+    if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles) {
+        return -1;
+    }
+
+    return this->componentLabels.at(row * this->xTiles + col);
+}
+
+// Get the connected component a vertex is part of
+int GridEnvironment::getComponent(Vertex<Grid<int>> *vertex) {
+    if (vertex == nullptr) {
+        return -1;
+    }
+
+    return this->getComponent(vertex->getElement().row, vertex->getElement().column);
+}
+
+// Return true if there is a path between two vertices
+bool GridEnvironment::isReachable(Vertex<Grid<int>> *from, Vertex<Grid<int>> *to) {
+    int component = this->getComponent(from);
+    return component != -1 && component == this->getComponent(to);
+}
+
+// Find the closest vertex to a position that is part of a given component (-1 accepts any open tile), or nullptr if there is none
+Vertex<Grid<int>> *GridEnvironment::nearestInComponent(sf::Vector2f position, int component) {
+    int row = std::max(0, std::min(this->yTiles - 1, (int) (position.y / this->tileHeight)));
+    int col = std::max(0, std::min(this->xTiles - 1, (int) (position.x / this->tileWidth)));
+
+    // Search rings of tiles around the position, taking the closest matching tile in the first ring that has one
+    for (int radius = 0; radius < std::max(this->xTiles, this->yTiles); radius++) {
+        int bestRow = -1;
+        int bestCol = -1;
+        float bestDistance = 0;
+
+        for (int r = row - radius; r <= row + radius; r++) {
+            for (int c = col - radius; c <= col + radius; c++) {
+                // Only look at the edge of the ring
+                if (std::abs(r - row) != radius && std::abs(c - col) != radius) {
+                    continue;
+                }
+
+                int label = this->getComponent(r, c);
+                if (label == -1 || (component != -1 && label != component)) {
+                    continue;
+                }
+
+                sf::Vector2f center((c + 0.5f) * this->tileWidth, (r + 0.5f) * this->tileHeight);
+                float distance = (center.x - position.x) * (center.x - position.x) + (center.y - position.y) * (center.y - position.y);
+                if (bestRow == -1 || distance < bestDistance) {
+                    bestRow = r;
+                    bestCol = c;
+                    bestDistance = distance;
+                }
+            }
+        }
+
+        if (bestRow != -1) {
+            return this->quantize(sf::Vector2f((bestCol + 0.5f) * this->tileWidth, (bestRow + 0.5f) * this->tileHeight));
+        }
+    }
+
+    return nullptr;
+}
+
+// Label every connected component of open tiles from scratch
+void GridEnvironment::labelComponents() {
+    this->componentLabels.assign(this->xTiles * this->yTiles, -1);
+    this->nextComponent = 0;
+
+    std::deque<int> frontier;
+    for (int start = 0; start < this->xTiles * this->yTiles; start++) {
+        if (this->isObstacle(start / this->xTiles, start % this->xTiles) || this->componentLabels[start] != -1) {
+            continue;
+        }
+
+        // Flood fill the component the tile is part of
+        this->componentLabels[start] = this->nextComponent;
+        frontier.push_back(start);
+        while (frontier.size() > 0) {
+            int cell = frontier.front();
+            frontier.pop_front();
+
+            for (int d = 0; d < 4; d++) {
+                int row = cell / this->xTiles + neighborRow[d];
+                int col = cell % this->xTiles + neighborCol[d];
+                int next = row * this->xTiles + col;
+                if (row >= 0 && row < this->yTiles && col >= 0 && col < this->xTiles && !this->isObstacle(row, col) && this->componentLabels[next] == -1) {
+                    this->componentLabels[next] = this->nextComponent;
+                    frontier.push_back(next);
+                }
+            }
+        }
+        this->nextComponent++;
+    }
+}
+
+// Relabel the pieces a component splits into after a tile in it was blocked
+// A breadth first search runs from each open neighbour in lockstep, merging when they meet, so only the smaller pieces are walked
+void GridEnvironment::splitComponent(int row, int col, int label) {
+    int dRow[] = {-1, 1, 0, 0};
+    int dCol[] = {0, 0, -1, 1};
+
+    // Start a search from each neighbour that was in the component
+    std::vector<std::deque<int>> frontiers;
+    std::vector<std::vector<int>> visited;
+    for (int i = 0; i < 4; i++) {
+        int r = row + dRow[i];
+        int c = col + dCol[i];
+        if (this->getComponent(r, c) == label && this->componentScratch.at(r * this->xTiles + c) == -1) {
+            this->componentScratch.at(r * this->xTiles + c) = frontiers.size();
+            frontiers.push_back(std::deque<int>(1, r * this->xTiles + c));
+            visited.push_back(std::vector<int>(1, r * this->xTiles + c));
+        }
+    }
+
+    // Searches that meet belong to the same piece, so track them as groups
+    std::vector<int> group(frontiers.size());
+    for (std::vector<int>::size_type i = 0; i < group.size(); i++) {
+        group.at(i) = i;
+    }
+    std::function<int(int)> findGroup = [&group, &findGroup](int i) -> int {
+        return group.at(i) == i ? i : group.at(i) = findGroup(group.at(i));
+    };
+
+    std::vector<bool> finished(frontiers.size(), false);
+    int unfinished = frontiers.size();
+
+    // Once only one group is left unfinished, it keeps the old label
+    while (unfinished > 1) {
+        for (std::vector<std::deque<int>>::size_type i = 0; i < frontiers.size(); i++) {
+            if (frontiers.at(i).size() == 0) {
+                continue;
+            }
+
+            int cell = frontiers.at(i).front();
+            frontiers.at(i).pop_front();
+
+            for (int d = 0; d < 4; d++) {
+                int r = cell / this->xTiles + dRow[d];
+                int c = cell % this->xTiles + dCol[d];
+                if (this->getComponent(r, c) != label) {
+                    continue;
+                }
+
+                int next = r * this->xTiles + c;
+                int owner = this->componentScratch.at(next);
+                if (owner == -1) {
+                    this->componentScratch.at(next) = i;
+                    frontiers.at(i).push_back(next);
+                    visited.at(i).push_back(next);
+                } else if (findGroup(owner) != findGroup(i)) {
+                    group.at(findGroup(owner)) = findGroup(i);
+                    unfinished--;
+                }
+            }
+        }
+
+        // A group whose searches have all run out has walked an entire piece, so give it a new label
+        for (std::vector<std::deque<int>>::size_type i = 0; i < frontiers.size(); i++) {
+            int root = findGroup(i);
+            if (root != (int) i || finished.at(root)) {
+                continue;
+            }
+
+            bool exhausted = true;
+            for (std::vector<std::deque<int>>::size_type j = 0; j < frontiers.size(); j++) {
+                exhausted = exhausted && (findGroup(j) != root || frontiers.at(j).size() == 0);
+            }
+            if (!exhausted || unfinished == 1) {
+                continue;
+            }
+
+            int newLabel = this->nextComponent++;
+            for (std::vector<std::deque<int>>::size_type j = 0; j < frontiers.size(); j++) {
+                if (findGroup(j) == root) {
+                    for (int cell : visited.at(j)) {
+                        this->componentLabels.at(cell) = newLabel;
+                    }
+                }
+            }
+            finished.at(root) = true;
+            unfinished--;
+        }
+    }
+
+    // Clean up the scratch space for the next split
+    for (std::vector<int> &cells : visited) {
+        for (int cell : cells) {
+            this->componentScratch.at(cell) = -1;
+        }
+    }
+}
+
+// Recompute the left and right obstacle steps of every tile in a row
+void GridEnvironment::updateRowSteps(int row) {
+    int base = row * this->xTiles;
+    for (int col = 0; col < this->xTiles; col++) {
+        this->stepsLeft.at(base + col) = col == 0 || this->isObstacle(row, col - 1) ? 1 : this->stepsLeft.at(base + col - 1) + 1;
+    }
+    for (int col = this->xTiles - 1; col >= 0; col--) {
+        this->stepsRight.at(base + col) = col == this->xTiles - 1 || this->isObstacle(row, col + 1) ? 1 : this->stepsRight.at(base + col + 1) + 1;
+    }
+}
+
+// Recompute the up and down obstacle steps of every tile in a column
+void GridEnvironment::updateColumnSteps(int col) {
+    for (int row = 0; row < this->yTiles; row++) {
+        int index = row * this->xTiles + col;
+        this->stepsUp.at(index) = row == 0 || this->isObstacle(row - 1, col) ? 1 : this->stepsUp.at(index - this->xTiles) + 1;
+    }
+    for (int row = this->yTiles - 1; row >= 0; row--) {
+        int index = row * this->xTiles + col;
+        this->stepsDown.at(index) = row == this->yTiles - 1 || this->isObstacle(row + 1, col) ? 1 : this->stepsDown.at(index + this->xTiles) + 1;
+    }
+}
+
+// Find the squared distance from each sample to the nearest zero of f (the lower envelope of parabolas rooted at every sample)
+static void distanceTransform(std::vector<float> *f, int n) {
+    std::vector<float> d(n);
+    std::vector<int> v(n);
+    std::vector<float> z(n + 1);
+    const float far = 1e20f;
+
+    int k = 0;
+    v[0] = 0;
+    z[0] = -far;
+    z[1] = far;
+    for (int q = 1; q < n; q++) {
+        float s = ((f->at(q) + q * q) - (f->at(v[k]) + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f->at(q) + q * q) - (f->at(v[k]) + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = far;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f->at(v[k]);
+    }
+
+    *f = d;
+}
+
+// Rebuild the Euclidean distance from every tile to the nearest obstacle (a transform down each column, then along each row)
+// Adapted from "Distance Transforms of Sampled Functions" by Felzenszwalb and Huttenlocher
+void GridEnvironment::updateObstacleDistances() {
+    this->obstacleDistances = std::vector<float>(this->xTiles * this->yTiles);
+
+    std::vector<float> column(this->yTiles);
+    for (int col = 0; col < this->xTiles; col++) {
+        for (int row = 0; row < this->yTiles; row++) {
+            column[row] = this->isObstacle(row, col) ? 0 : 1e20f;
+        }
+        distanceTransform(&column, this->yTiles);
+        for (int row = 0; row < this->yTiles; row++) {
+            this->obstacleDistances.at(row * this->xTiles + col) = column[row];
+        }
+    }
+
+    std::vector<float> line(this->xTiles);
+    for (int row = 0; row < this->yTiles; row++) {
+        for (int col = 0; col < this->xTiles; col++) {
+            line[col] = this->obstacleDistances.at(row * this->xTiles + col);
+        }
+        distanceTransform(&line, this->xTiles);
+        for (int col = 0; col < this->xTiles; col++) {
+            this->obstacleDistances.at(row * this->xTiles + col) = std::sqrt(line[col]);
+        }
+    }
+
+    this->obstacleDistancesStale = false;
+}
+
+// Find the first blocked tile in a run of columns of a row, scanning forwards or backwards (columns outside of the grid count as blocked)
+bool GridEnvironment::firstBlocked(int row, int colStart, int colEnd, bool forward, int *blockedCol) {
+    if (forward && colStart < 0) {
+        *blockedCol = colStart;
+        return true;
+    } else if (!forward && colEnd >= this->xTiles) {
+        *blockedCol = colEnd;
+        return true;
+    }
+
+    int first = std::max(colStart, 0);
+    int last = std::min(colEnd, this->xTiles - 1);
+    const uint64_t *words = &this->packedRows.at(row * this->wordsPerRow);
+
+    if (forward) {
+        for (int word = first / 64; word <= last / 64; word++) {
+            uint64_t bits = words[word];
+            if (word == first / 64) {
+                bits &= ~(uint64_t) 0 << (first % 64);
+            }
+            if (word == last / 64 && last % 64 != 63) {
+                bits &= ((uint64_t) 1 << (last % 64 + 1)) - 1;
+            }
+            if (bits != 0) {
+                *blockedCol = word * 64 + __builtin_ctzll(bits);
+                return true;
+            }
+        }
+    } else {
+        for (int word = last / 64; word >= first / 64; word--) {
+            uint64_t bits = words[word];
+            if (word == first / 64) {
+                bits &= ~(uint64_t) 0 << (first % 64);
+            }
+            if (word == last / 64 && last % 64 != 63) {
+                bits &= ((uint64_t) 1 << (last % 64 + 1)) - 1;
+            }
+            if (bits != 0) {
+                *blockedCol = word * 64 + 63 - __builtin_clzll(bits);
+                return true;
+            }
+        }
+    }
+
+    // Nothing in the grid is blocked, but the run may still leave it
+    if (colEnd >= this->xTiles) {
+        *blockedCol = this->xTiles;
+        return true;
+    } else if (colStart < 0) {
+        *blockedCol = -1;
+        return true;
+    }
+    return false;
+}
+
+// Return true if the line between the centers of two tiles crosses no obstacles
+bool GridEnvironment::tilesSeeEachOther(int from, int to) {
+    sf::Vector2f fromCenter(((from % this->xTiles) + 0.5f) * this->tileWidth, ((from / this->xTiles) + 0.5f) * this->tileHeight);
+    sf::Vector2f toCenter(((to % this->xTiles) + 0.5f) * this->tileWidth, ((to / this->xTiles) + 0.5f) * this->tileHeight);
+    return this->lineOfSight(fromCenter, toCenter);
+}
+
+// Patch the precomputed visibility after a tile is blocked or opened
+// Only lines that can pass through the tile are rechecked. From each open tile, those lead to the tiles inside the cone its center
+// casts through the tile's corners, which is found a row at a time, and each line is rechecked with a raycast over the packed rows
+void GridEnvironment::updateVisibility(int row, int col) {
+    int tiles = this->xTiles * this->yTiles;
+    int changed = row * this->xTiles + col;
+    bool opened = !this->isObstacle(row, col);
+
+    // An obstacle tile sees nothing and is seen by nothing
+    for (int tile = 0; tile < tiles; tile++) {
+        this->visibility[(std::size_t) tile * this->visibilityWords + changed / 64] &= ~((uint64_t) 1 << (changed % 64));
+    }
+    std::fill_n(this->visibility.begin() + (std::size_t) changed * this->visibilityWords, this->visibilityWords, 0);
+
+    // An opened tile sees itself and every open tile it has a clear line to
+    if (opened) {
+        this->visibility[(std::size_t) changed * this->visibilityWords + changed / 64] |= (uint64_t) 1 << (changed % 64);
+        for (int to = 0; to < tiles; to++) {
+            if (to != changed && !this->isObstacle(to / this->xTiles, to % this->xTiles) && this->tilesSeeEachOther(changed, to)) {
+                this->visibility[(std::size_t) changed * this->visibilityWords + to / 64] |= (uint64_t) 1 << (to % 64);
+                this->visibility[(std::size_t) to * this->visibilityWords + changed / 64] |= (uint64_t) 1 << (changed % 64);
+            }
+        }
+    }
+
+    for (int from = 0; from < tiles; from++) {
+        int fromRow = from / this->xTiles;
+        int fromCol = from % this->xTiles;
+        if (from == changed || this->isObstacle(fromRow, fromCol)) {
+            continue;
+        }
+
+        // Work in tile coordinates, where tile centers sit at (col + 0.5, row + 0.5)
+        double fx = fromCol + 0.5;
+        double fy = fromRow + 0.5;
+
+        // A line through the tile ends on the far side of it (or level with it), in both the row and the column
+        int firstRow = fromRow < row ? row : 0;
+        int lastRow = fromRow > row ? row : this->yTiles - 1;
+        int firstCol = fromCol < col ? col : 0;
+        int lastCol = fromCol > col ? col : this->xTiles - 1;
+
+        for (int toRow = firstRow; toRow <= lastRow; toRow++) {
+            // Find the columns of this row inside the cone, from where the rays through each corner cross the row's centers
+            // (a tile level with the changed row casts a cone that opens out to the side, away from the tile)
+            double dy = toRow + 0.5 - fy;
+            int colStart = firstCol;
+            int colEnd = lastCol;
+            if (dy != 0) {
+                double xMin = std::numeric_limits<double>::max();
+                double xMax = -std::numeric_limits<double>::max();
+                for (int corner = 0; corner < 4; corner++) {
+                    double cx = col + corner % 2;
+                    double cy = row + corner / 2;
+                    if ((cy - fy) * dy <= 0) {
+                        continue;
+                    }
+
+                    double x = fx + (cx - fx) * dy / (cy - fy);
+                    xMin = std::min(xMin, x);
+                    xMax = std::max(xMax, x);
+                }
+
+                if (fromRow != row || fromCol < col) {
+                    colStart = std::max(colStart, (int) std::ceil(xMin - 0.5 - 1e-6));
+                }
+                if (fromRow != row || fromCol > col) {
+                    colEnd = std::min(colEnd, (int) std::floor(xMax - 0.5 + 1e-6));
+                }
+            }
+
+            // Each pair is handled once, from its lower tile, and only rechecked if the change could flip it
+            for (int toCol = std::max(colStart, 0); toCol <= std::min(colEnd, this->xTiles - 1); toCol++) {
+                int to = toRow * this->xTiles + toCol;
+                if (to <= from || to == changed || this->isObstacle(toRow, toCol)) {
+                    continue;
+                }
+
+                bool visible = (this->visibility[(std::size_t) from * this->visibilityWords + to / 64] >> (to % 64)) & 1;
+                if (visible == opened || this->tilesSeeEachOther(from, to) == visible) {
+                    continue;
+                }
+
+                this->visibility[(std::size_t) from * this->visibilityWords + to / 64] ^= (uint64_t) 1 << (to % 64);
+                this->visibility[(std::size_t) to * this->visibilityWords + from / 64] ^= (uint64_t) 1 << (from % 64);
+            }
+        }
+    }
+}
+
+// Rebuild a tile's edge lists from its open neighbours, in the order buildGraph built them
+void GridEnvironment::orderEdges(int index) {
+    std::vector<Edge<int>*> *outgoing = this->getGraph()->outgoingEdges(this->tileVertices[index]);
+    std::vector<Edge<int>*> *incoming = this->getGraph()->incomingEdges(this->tileVertices[index]);
+    outgoing->clear();
+    incoming->clear();
+
+    for (int d = 0; d < 4; d++) {
+        if (this->tileEdges[index][d] != nullptr && this->cells[index + neighborRow[d] * this->xTiles + neighborCol[d]] != nullptr) {
+            outgoing->push_back(this->tileEdges[index][d]);
+            incoming->push_back(this->tileEdges[index + neighborRow[d] * this->xTiles + neighborCol[d]][3 - d]);
+        }
+    }
+}
+
+// Join an opened tile to the components of its neighbours, relabeling every component it connects to match the first
+void GridEnvironment::mergeComponents(int row, int col) {
+    int index = row * this->xTiles + col;
+    int label = -1;
+
+    for (int d = 0; d < 4; d++) {
+        int other = this->getComponent(row + neighborRow[d], col + neighborCol[d]);
+        if (other == -1 || other == label) {
+            continue;
+        } else if (label == -1) {
+            label = other;
+            continue;
+        }
+
+        // Flood the other component with this label
+        int start = index + neighborRow[d] * this->xTiles + neighborCol[d];
+        std::deque<int> frontier(1, start);
+        this->componentLabels.at(start) = label;
+        while (frontier.size() > 0) {
+            int cell = frontier.front();
+            frontier.pop_front();
+
+            for (int e = 0; e < 4; e++) {
+                int r = cell / this->xTiles + neighborRow[e];
+                int c = cell % this->xTiles + neighborCol[e];
+                if (this->getComponent(r, c) == other) {
+                    this->componentLabels.at(r * this->xTiles + c) = label;
+                    frontier.push_back(r * this->xTiles + c);
+                }
+            }
+        }
+    }
+
+    // A tile with no open neighbours is a component of its own
+    this->componentLabels.at(index) = label == -1 ? this->nextComponent++ : label;
+}
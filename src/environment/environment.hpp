@@ -3,7 +3,13 @@
 
 #include <SFML/Graphics.hpp>
 #include <map>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <functional>
 #include "../utils/graph/graph.hpp"
+#include "../utils/graph/flat-graph.hpp"
+#include "../utils/graph/implicit-grid-graph.hpp"
 #include "../utils/kinematics/kinematics.hpp"
 
 class Engine;
@@ -54,10 +60,18 @@ class Environment {
         // Obstacles inside of the game environment
         std::vector<Obstacle*> obstacles;
 
+        // Flat copy of the graph, rebuilt the first time it is needed after the graph changes
+        FlatGraph<V, E> flatGraph;
+        bool flatGraphStale = true;
+
+    protected:
+        // Fill in the graph before it is first handed out (environments that build their graph lazily override this)
+        virtual void buildGraph() {}
 
     public:
         // Create a new environment with reference to the engine
         Environment() {}
+        virtual ~Environment() {}
 
         // Quantize a given environment position to a vertex on the graph
         virtual Vertex<V> *quantize(sf::Vector2f position) = 0;
@@ -67,19 +81,40 @@ class Environment {
 
         // Getters
         AdjacencyListGraph<V, E> *getGraph() {
+            this->buildGraph();
             return &this->graph;
         }
         std::vector<Obstacle*> *getObstacles() {
             return &this->obstacles;
         }
+        FlatGraph<V, E> *getFlatGraph() {
+            this->buildGraph();
+            if (this->flatGraphStale) {
+                this->flatGraph = FlatGraph<V, E>(&this->graph);
+                this->flatGraphStale = false;
+            }
+            return &this->flatGraph;
+        }
 
         // Setters
         void setGraph(AdjacencyListGraph<V, E> graph) {
             this->graph = graph;
+            this->flatGraphStale = true;
+        }
+
+        // Mark the flat copy of the graph as out of date (call after changing the graph)
+        void invalidateGraph() {
+            this->flatGraphStale = true;
         }
 };
 
 
+// Ray represents a line segment between two environment positions
+struct Ray {
+    sf::Vector2f from;
+    sf::Vector2f to;
+};
+
 // GridEnvironment class represents an environment coded as a grid system
 class GridEnvironment : public Environment<Grid<int>, int> {
     private:
@@ -92,6 +127,56 @@ class GridEnvironment : public Environment<Grid<int>, int> {
         int height;
         int width;
 
+        // Row-major vertex of each tile (nullptr for obstacles), empty until the graph is built
+        std::vector<Vertex<Grid<int>>*> cells;
+        bool graphBuilt = false;
+
+        // Row-major vertex and outgoing edges (up, left, right, down) of each tile, kept while the tile is blocked
+        std::vector<Vertex<Grid<int>>*> tileVertices;
+        std::vector<std::array<Edge<int>*, 4>> tileEdges;
+
+        // Functions called whenever a tile is blocked or opened
+        std::vector<std::function<void(int, int, bool)>> cellListeners;
+
+        // Implicit copy of the grid that holds the obstacle bitmap and the tile costs
+        ImplicitGridGraph<int> gridGraph;
+
+        // Row-major connected component label of each tile (-1 for obstacles)
+        std::vector<int> componentLabels;
+        std::vector<int> componentScratch;
+        int nextComponent = 0;
+
+        // Tiles stepped from each tile to the nearest obstacle (or edge of the grid) moving up, down, left and right
+        std::vector<int> stepsUp;
+        std::vector<int> stepsDown;
+        std::vector<int> stepsLeft;
+        std::vector<int> stepsRight;
+
+        // Euclidean distance from each tile to the nearest obstacle, rebuilt the first time it is needed after an obstacle is added
+        std::vector<float> obstacleDistances;
+        bool obstacleDistancesStale = true;
+
+        // Obstacle bitmap packed 64 tiles to a word, so a run of tiles in a row is checked a word at a time
+        std::vector<uint64_t> packedRows;
+        int wordsPerRow = 0;
+
+        // Bitset per tile of the tiles whose centers it can see (empty until buildVisibility is called)
+        std::vector<uint64_t> visibility;
+        int visibilityWords = 0;
+
+        void buildGraph();
+        void attachOpenTiles();
+        void labelComponents();
+        void splitComponent(int row, int col, int label);
+        void mergeComponents(int row, int col);
+        void orderEdges(int index);
+        void updateRowSteps(int row);
+        void updateColumnSteps(int col);
+        void updateObstacleDistances();
+        bool firstBlocked(int row, int colStart, int colEnd, bool forward, int *blockedCol);
+        bool tilesSeeEachOther(int from, int to);
+        void updateVisibility(int row, int col);
+
     public:
         GridEnvironment(int xTiles, int yTiles, int width, int height);
 
@@ -99,8 +184,33 @@ class GridEnvironment : public Environment<Grid<int>, int> {
         sf::Vector2f localize(Vertex<Grid<int>> *vertex);
 
         bool isObstacle(int row, int col);
+        Vertex<Grid<int>> *getVertex(int row, int col);
+        Edge<int> *getEdge(int row, int col, int toRow, int toCol);
+        int obstacleSteps(int row, int col, int dRow, int dCol);
+        float obstacleDistance(int row, int col);
+
+        bool lineOfSight(sf::Vector2f from, sf::Vector2f to);
+        void lineOfSight(const std::vector<Ray> &rays, std::vector<bool> *visible);
+        float raycast(sf::Vector2f from, sf::Vector2f to);
+        void raycast(const std::vector<Ray> &rays, std::vector<float> *distances);
+
+        void buildVisibility(unsigned int threads = 0);
+        bool isVisibilityBuilt();
+        bool isVisible(int row, int col, int toRow, int toCol);
+        ImplicitGridGraph<int> *getGridGraph();
         void addObstacle(GridObstacle *gridObstacle);
+        void addObstacles(const std::vector<GridObstacle*> &gridObstacles);
+        void removeObstacle(GridObstacle *gridObstacle);
+        void setCellBlocked(int row, int col, bool blocked);
+        void setCellCost(int row, int col, int cost);
+        void setObstacleLayout(const std::vector<bool> &blocked);
+        void addCellListener(std::function<void(int, int, bool)> listener);
         sf::Vector2f localizeEndpoint(Edge<int> *edge, int index);
+
+        int getComponent(int row, int col);
+        int getComponent(Vertex<Grid<int>> *vertex);
+        bool isReachable(Vertex<Grid<int>> *from, Vertex<Grid<int>> *to);
+        Vertex<Grid<int>> *nearestInComponent(sf::Vector2f position, int component);
 };
 
 #endif
\ No newline at end of file
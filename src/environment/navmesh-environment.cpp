@@ -0,0 +1,352 @@
+#include "navmesh-environment.hpp"
+#include <array>
+#include <cmath>
+#include <queue>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+// Twice the signed area of the triangle (apex, a, b) (positive when b is to the right of apex -> a)
+static float triangleArea(sf::Vector2f apex, sf::Vector2f a, sf::Vector2f b) {
+    return (b.x - apex.x) * (a.y - apex.y) - (a.x - apex.x) * (b.y - apex.y);
+}
+
+// Distance between two positions
+static float distance(sf::Vector2f a, sf::Vector2f b) {
+    return std::hypot(b.x - a.x, b.y - a.y);
+}
+
+/* NavPolygon Class */
+
+// Create a polygon from its corners (the center is the average of the corners)
+NavPolygon::NavPolygon(std::vector<sf::Vector2f> points) {
+    this->points = points;
+    this->center = sf::Vector2f(0, 0);
+    for (sf::Vector2f point : points) {
+        this->center += point;
+    }
+    this->center /= (float) points.size();
+}
+
+// Return true if a position is inside the polygon or on its boundary
+bool NavPolygon::contains(sf::Vector2f position) {
+    for (std::vector<sf::Vector2f>::size_type i = 0; i < this->points.size(); i++) {
+        sf::Vector2f a = this->points.at(i);
+        sf::Vector2f b = this->points.at((i + 1) % this->points.size());
+        if ((b.x - a.x) * (position.y - a.y) - (b.y - a.y) * (position.x - a.x) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* NavMeshEnvironment Class */
+
+// Build a navigation mesh over the open tiles of a grid environment
+NavMeshEnvironment::NavMeshEnvironment(GridEnvironment *grid, int xTiles, int yTiles, int width, int height, int bucketTiles) {
+    this->xTiles = xTiles;
+    this->yTiles = yTiles;
+    this->tileWidth = width / xTiles;
+    this->tileHeight = height / yTiles;
+    this->bucketTiles = bucketTiles;
+
+    this->setGraph(AdjacencyListGraph<NavPolygon, float>(true));
+    AdjacencyListGraph<NavPolygon, float> *graph = this->getGraph();
+
+    // Greedily cover the open tiles with rectangles, growing each one right as far as it can and then down
+    std::vector<int> tilePolygon(xTiles * yTiles, -1);
+    std::vector<std::array<int, 4>> rectangles; // First row, first column, last row, last column
+    for (int row = 0; row < yTiles; row++) {
+        for (int col = 0; col < xTiles; col++) {
+            if (tilePolygon[row * xTiles + col] != -1 || grid->isObstacle(row, col)) {
+                continue;
+            }
+
+            int lastCol = col;
+            while (lastCol + 1 < xTiles && tilePolygon[row * xTiles + lastCol + 1] == -1 && !grid->isObstacle(row, lastCol + 1)) {
+                lastCol++;
+            }
+
+            int lastRow = row;
+            bool grow = true;
+            while (grow && lastRow + 1 < yTiles) {
+                for (int c = col; c <= lastCol; c++) {
+                    if (tilePolygon[(lastRow + 1) * xTiles + c] != -1 || grid->isObstacle(lastRow + 1, c)) {
+                        grow = false;
+                        break;
+                    }
+                }
+                if (grow) {
+                    lastRow++;
+                }
+            }
+
+            for (int r = row; r <= lastRow; r++) {
+                for (int c = col; c <= lastCol; c++) {
+                    tilePolygon[r * xTiles + c] = rectangles.size();
+                }
+            }
+            rectangles.push_back({row, col, lastRow, lastCol});
+
+            float left = col * this->tileWidth;
+            float top = row * this->tileHeight;
+            float right = (lastCol + 1) * this->tileWidth;
+            float bottom = (lastRow + 1) * this->tileHeight;
+            this->polygons.push_back(graph->insertVertex(NavPolygon({sf::Vector2f(left, top), sf::Vector2f(right, top), sf::Vector2f(right, bottom), sf::Vector2f(left, bottom)})));
+        }
+    }
+
+    // Connect each rectangle to the rectangles touching its right and bottom sides (one portal per run of tiles)
+    for (std::vector<std::array<int, 4>>::size_type i = 0; i < rectangles.size(); i++) {
+        std::array<int, 4> rect = rectangles.at(i);
+
+        if (rect[3] + 1 < xTiles) {
+            int c = rect[3] + 1;
+            for (int r = rect[0]; r <= rect[2];) {
+                int neighbor = tilePolygon[r * xTiles + c];
+                int runStart = r;
+                while (r <= rect[2] && tilePolygon[r * xTiles + c] == neighbor) {
+                    r++;
+                }
+                if (neighbor != -1) {
+                    this->addPortals(this->polygons.at(i), this->polygons.at(neighbor), sf::Vector2f(c * this->tileWidth, runStart * this->tileHeight), sf::Vector2f(c * this->tileWidth, r * this->tileHeight));
+                }
+            }
+        }
+
+        if (rect[2] + 1 < yTiles) {
+            int r = rect[2] + 1;
+            for (int c = rect[1]; c <= rect[3];) {
+                int neighbor = tilePolygon[r * xTiles + c];
+                int runStart = c;
+                while (c <= rect[3] && tilePolygon[r * xTiles + c] == neighbor) {
+                    c++;
+                }
+                if (neighbor != -1) {
+                    this->addPortals(this->polygons.at(i), this->polygons.at(neighbor), sf::Vector2f(runStart * this->tileWidth, r * this->tileHeight), sf::Vector2f(c * this->tileWidth, r * this->tileHeight));
+                }
+            }
+        }
+    }
+
+    // Index each polygon in every bucket its rectangle overlaps
+    this->xBuckets = (xTiles + bucketTiles - 1) / bucketTiles;
+    this->yBuckets = (yTiles + bucketTiles - 1) / bucketTiles;
+    this->buckets = std::vector<std::vector<Vertex<NavPolygon>*>>(this->xBuckets * this->yBuckets);
+    for (std::vector<std::array<int, 4>>::size_type i = 0; i < rectangles.size(); i++) {
+        std::array<int, 4> rect = rectangles.at(i);
+        for (int by = rect[0] / bucketTiles; by <= rect[2] / bucketTiles; by++) {
+            for (int bx = rect[1] / bucketTiles; bx <= rect[3] / bucketTiles; bx++) {
+                this->buckets[by * this->xBuckets + bx].push_back(this->polygons.at(i));
+            }
+        }
+    }
+}
+
+// Delete the polygons and the edges between them
+NavMeshEnvironment::~NavMeshEnvironment() {
+    for (Edge<float> *edge : this->getGraph()->edges()) {
+        delete edge;
+    }
+    for (Vertex<NavPolygon> *polygon : this->polygons) {
+        delete polygon;
+    }
+}
+
+// Connect two polygons in both directions across the segment a-b they share
+void NavMeshEnvironment::addPortals(Vertex<NavPolygon> *from, Vertex<NavPolygon> *to, sf::Vector2f a, sf::Vector2f b) {
+    sf::Vector2f fromCenter = from->getElement().center;
+    sf::Vector2f toCenter = to->getElement().center;
+    float cost = distance(fromCenter, toCenter);
+
+    // Seen from the first polygon, the right side of the portal is the endpoint to the right of the direction of travel
+    NavPortal forward;
+    if ((toCenter.x - fromCenter.x) * (a.y - b.y) - (toCenter.y - fromCenter.y) * (a.x - b.x) < 0) {
+        forward.left = b;
+        forward.right = a;
+    } else {
+        forward.left = a;
+        forward.right = b;
+    }
+
+    NavPortal backward;
+    backward.left = forward.right;
+    backward.right = forward.left;
+
+    AdjacencyListGraph<NavPolygon, float> *graph = this->getGraph();
+    this->portals[graph->insertEdge(from, to, cost)] = forward;
+    this->portals[graph->insertEdge(to, from, cost)] = backward;
+}
+
+// Quantize a given environment position to the polygon containing it (or nullptr if it is inside an obstacle or off of the mesh)
+Vertex<NavPolygon> *NavMeshEnvironment::quantize(sf::Vector2f position) {
+    int column = position.x / this->tileWidth;
+    int row = position.y / this->tileHeight;
+    if (position.x < 0 || position.y < 0 || row >= this->yTiles || column >= this->xTiles) {
+        return nullptr;
+    }
+
+    for (Vertex<NavPolygon> *polygon : this->buckets[(row / this->bucketTiles) * this->xBuckets + column / this->bucketTiles]) {
+        if (polygon->getElement().contains(position)) {
+            return polygon;
+        }
+    }
+
+    return nullptr;
+}
+
+// Localize a given polygon to its center
+sf::Vector2f NavMeshEnvironment::localize(Vertex<NavPolygon> *vertex) {
+    return vertex->getElement().center;
+}
+
+// Return the number of polygons in the mesh
+int NavMeshEnvironment::numPolygons() {
+    return this->polygons.size();
+}
+
+// Get the portal an edge crosses (or nullptr if the edge isn't part of the mesh)
+NavPortal *NavMeshEnvironment::getPortal(Edge<float> *edge) {
+    std::unordered_map<Edge<float>*, NavPortal>::iterator it = this->portals.find(edge);
+    return it == this->portals.end() ? nullptr : &it->second;
+}
+
+// Find a path between two positions, returned as the corners it turns at (the first waypoint is from and the last is to)
+bool NavMeshEnvironment::findPath(sf::Vector2f from, sf::Vector2f to, std::vector<sf::Vector2f> *waypoints, SearchStats *stats) {
+    SEARCH_STATS(SearchTimer timer(stats);)
+
+    Vertex<NavPolygon> *startPolygon = this->quantize(from);
+    Vertex<NavPolygon> *endPolygon = this->quantize(to);
+    if (startPolygon == nullptr || endPolygon == nullptr) {
+        return false;
+    }
+
+    // A* over the polygons, measuring each one from the midpoint of the portal it was entered through (the start
+    // polygon is measured from the start position) so long polygons don't skew costs the way their centers would
+    FlatGraph<NavPolygon, float> *graph = this->getFlatGraph();
+    int start = graph->id(startPolygon);
+    int end = graph->id(endPolygon);
+    int n = graph->numVertices();
+
+    std::vector<float> costSoFar(n, std::numeric_limits<float>::infinity());
+    std::vector<int> parent(n, -1);
+    std::vector<sf::Vector2f> entry(n);
+    std::vector<char> closed(n, 0);
+
+    std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>> openList;
+    costSoFar[start] = 0;
+    entry[start] = from;
+    openList.push(std::make_pair(distance(from, to), start));
+    SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; stats->recordOpenList(openList.size()); })
+
+    while (openList.size() > 0 && !closed[end]) {
+        int v = openList.top().second;
+        openList.pop();
+        if (closed[v]) {
+            continue;
+        }
+        closed[v] = 1;
+        SEARCH_STATS(if (stats != nullptr) { stats->nodesExpanded++; })
+
+        for (int arc = graph->arcsBegin(v); arc < graph->arcsEnd(v); arc++) {
+            int neighbor = graph->target(arc);
+            if (closed[neighbor]) {
+                continue;
+            }
+
+            NavPortal *portal = this->getPortal(graph->edge(arc));
+            sf::Vector2f midpoint = (portal->left + portal->right) / 2.0f;
+            float cost = costSoFar[v] + distance(entry[v], midpoint);
+            float estimate = distance(midpoint, to);
+
+            // The goal's cost includes the last leg to the end position
+            if (neighbor == end) {
+                cost += estimate;
+                estimate = 0;
+            }
+
+            if (cost < costSoFar[neighbor]) {
+                costSoFar[neighbor] = cost;
+                parent[neighbor] = v;
+                entry[neighbor] = midpoint;
+                openList.push(std::make_pair(cost + estimate, neighbor));
+                SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; stats->recordOpenList(openList.size()); })
+            }
+        }
+    }
+
+    if (!closed[end]) {
+        return false;
+    }
+
+    std::vector<int> polygonPath;
+    for (int v = end; v != -1; v = parent[v]) {
+        polygonPath.push_back(v);
+    }
+    std::reverse(polygonPath.begin(), polygonPath.end());
+
+    // Pull the path tight through the portals between consecutive polygons
+    std::vector<NavPortal> portalList;
+    portalList.push_back({from, from});
+    for (std::vector<int>::size_type i = 1; i < polygonPath.size(); i++) {
+        portalList.push_back(*this->getPortal(graph->edge(graph->arcBetween(polygonPath.at(i - 1), polygonPath.at(i)))));
+    }
+    portalList.push_back({to, to});
+
+    this->smoothPath(portalList, waypoints);
+    return true;
+}
+
+// Simple stupid funnel algorithm: narrow a funnel from the apex portal by portal, and add a corner whenever one side crosses the other
+void NavMeshEnvironment::smoothPath(const std::vector<NavPortal> &portalList, std::vector<sf::Vector2f> *waypoints) {
+    sf::Vector2f apex = portalList.at(0).left;
+    sf::Vector2f left = apex;
+    sf::Vector2f right = apex;
+    int apexIndex = 0;
+    int leftIndex = 0;
+    int rightIndex = 0;
+
+    waypoints->push_back(apex);
+
+    for (int i = 1; i < (int) portalList.size(); i++) {
+        const NavPortal &portal = portalList.at(i);
+
+        // Tighten the right side of the funnel, or turn at the left corner if the right side crosses it
+        if (triangleArea(apex, right, portal.right) <= 0) {
+            if (apex == right || triangleArea(apex, left, portal.right) > 0) {
+                right = portal.right;
+                rightIndex = i;
+            } else {
+                waypoints->push_back(left);
+                apex = left;
+                apexIndex = leftIndex;
+                right = apex;
+                rightIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+
+        // Tighten the left side of the funnel, or turn at the right corner if the left side crosses it
+        if (triangleArea(apex, left, portal.left) >= 0) {
+            if (apex == left || triangleArea(apex, right, portal.left) < 0) {
+                left = portal.left;
+                leftIndex = i;
+            } else {
+                waypoints->push_back(right);
+                apex = right;
+                apexIndex = rightIndex;
+                left = apex;
+                leftIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+    }
+
+    // The last portal collapses onto the end position
+    sf::Vector2f end = portalList.back().left;
+    if (waypoints->back() != end) {
+        waypoints->push_back(end);
+    }
+}
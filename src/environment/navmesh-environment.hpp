@@ -0,0 +1,69 @@
+#ifndef NAVMESH_ENVIRONMENT
+#define NAVMESH_ENVIRONMENT
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <unordered_map>
+#include "environment.hpp"
+#include "../utils/algorithm/stats.hpp"
+
+// NavPolygon class represents a vertex in a navigation mesh (a convex region of open space)
+class NavPolygon {
+    public:
+        std::vector<sf::Vector2f> points; // Corners in clockwise order on screen
+        sf::Vector2f center;
+
+        // Default constructor for a polygon
+        NavPolygon() {}
+
+        NavPolygon(std::vector<sf::Vector2f> points);
+
+        bool contains(sf::Vector2f position);
+};
+
+// NavPortal represents the edge shared by two neighbouring polygons, as seen when crossing it
+struct NavPortal {
+    sf::Vector2f left;
+    sf::Vector2f right;
+};
+
+// NavMeshEnvironment class represents an environment coded as convex polygons of open space
+//
+// The mesh is built from the obstacle layout of a grid environment by merging open tiles into rectangles,
+// so large open areas become a handful of vertices instead of one vertex per tile
+class NavMeshEnvironment : public Environment<NavPolygon, float> {
+    private:
+        float tileWidth;
+        float tileHeight;
+
+        int xTiles;
+        int yTiles;
+
+        // Polygons in the order they were built
+        std::vector<Vertex<NavPolygon>*> polygons;
+
+        // Portal crossed by each edge of the graph
+        std::unordered_map<Edge<float>*, NavPortal> portals;
+
+        // Spatial index of the polygons overlapping each bucket of tiles
+        int bucketTiles;
+        int xBuckets;
+        int yBuckets;
+        std::vector<std::vector<Vertex<NavPolygon>*>> buckets;
+
+        void addPortals(Vertex<NavPolygon> *from, Vertex<NavPolygon> *to, sf::Vector2f a, sf::Vector2f b);
+        void smoothPath(const std::vector<NavPortal> &portalList, std::vector<sf::Vector2f> *waypoints);
+
+    public:
+        NavMeshEnvironment(GridEnvironment *grid, int xTiles, int yTiles, int width, int height, int bucketTiles = 4);
+        ~NavMeshEnvironment();
+
+        Vertex<NavPolygon> *quantize(sf::Vector2f position);
+        sf::Vector2f localize(Vertex<NavPolygon> *vertex);
+
+        int numPolygons();
+        NavPortal *getPortal(Edge<float> *edge);
+        bool findPath(sf::Vector2f from, sf::Vector2f to, std::vector<sf::Vector2f> *waypoints, SearchStats *stats = nullptr);
+};
+
+#endif
@@ -0,0 +1,300 @@
+#include "quadtree-environment.hpp"
+#include <cmath>
+#include <algorithm>
+
+/* QuadtreeEnvironment Class */
+
+// Create a quadtree over a grid of tiles, copying the obstacle layout of a grid environment if one is given (otherwise every tile is open)
+QuadtreeEnvironment::QuadtreeEnvironment(int xTiles, int yTiles, int width, int height, GridEnvironment *grid) {
+    this->xTiles = xTiles;
+    this->yTiles = yTiles;
+    this->tileWidth = width / xTiles;
+    this->tileHeight = height / yTiles;
+
+    this->setGraph(AdjacencyListGraph<QuadCell, float>(true));
+
+    // The root is the smallest power of two square covering the grid
+    int size = 1;
+    while (size < xTiles || size < yTiles) {
+        size *= 2;
+    }
+    this->newNode(0, 0, size, -1, false);
+    this->build(0, grid);
+
+    // Create a vertex for each open leaf, then connect every leaf to its neighbours
+    std::vector<int> leaves;
+    this->collectLeaves(0, &leaves);
+    this->connect(leaves);
+}
+
+// Delete the blocks and the edges between them
+QuadtreeEnvironment::~QuadtreeEnvironment() {
+    for (Edge<float> *edge : this->getGraph()->edges()) {
+        delete edge;
+    }
+    for (Vertex<QuadCell> *vertex : this->getGraph()->vertices()) {
+        delete vertex;
+    }
+}
+
+// Add a leaf to the tree (reusing a freed node if there is one) and return its index
+int QuadtreeEnvironment::newNode(int row, int col, int size, int parent, bool blocked) {
+    QuadNode node;
+    node.row = row;
+    node.column = col;
+    node.size = size;
+    node.parent = parent;
+    node.children = {-1, -1, -1, -1};
+    node.blocked = blocked;
+
+    if (this->freeNodes.size() > 0) {
+        int index = this->freeNodes.back();
+        this->freeNodes.pop_back();
+        this->nodes[index] = node;
+        return index;
+    }
+
+    this->nodes.push_back(node);
+    return this->nodes.size() - 1;
+}
+
+// Build the subtree under a node bottom up, collapsing any four leaves that agree into their parent
+void QuadtreeEnvironment::build(int node, GridEnvironment *grid) {
+    int row = this->nodes[node].row;
+    int col = this->nodes[node].column;
+    int size = this->nodes[node].size;
+
+    // Blocks entirely off of the grid are blocked
+    if (row >= this->yTiles || col >= this->xTiles) {
+        this->nodes[node].blocked = true;
+        return;
+    }
+
+    // Blocks entirely on the grid with nothing to copy are open
+    if (grid == nullptr && row + size <= this->yTiles && col + size <= this->xTiles) {
+        this->nodes[node].blocked = false;
+        return;
+    }
+
+    if (size == 1) {
+        this->nodes[node].blocked = grid != nullptr && grid->isObstacle(row, col);
+        return;
+    }
+
+    // Building a child can grow the node list, so hold on to the indices rather than a reference
+    this->split(node);
+    std::array<int, 4> children = this->nodes[node].children;
+    bool uniform = true;
+    for (int child : children) {
+        this->build(child, grid);
+        if (this->nodes[child].children[0] != -1 || this->nodes[child].blocked != this->nodes[children[0]].blocked) {
+            uniform = false;
+        }
+    }
+
+    if (uniform) {
+        this->nodes[node].blocked = this->nodes[children[0]].blocked;
+        for (int child : children) {
+            this->freeNodes.push_back(child);
+        }
+        this->nodes[node].children = {-1, -1, -1, -1};
+    }
+}
+
+// Get the leaf covering a tile
+int QuadtreeEnvironment::leafAt(int row, int col) {
+    int node = 0;
+    while (this->nodes[node].children[0] != -1) {
+        int half = this->nodes[node].size / 2;
+        int quadrant = (row >= this->nodes[node].row + half ? 2 : 0) + (col >= this->nodes[node].column + half ? 1 : 0);
+        node = this->nodes[node].children[quadrant];
+    }
+    return node;
+}
+
+// Split a leaf into four leaves with its state
+void QuadtreeEnvironment::split(int node) {
+    int row = this->nodes[node].row;
+    int col = this->nodes[node].column;
+    int half = this->nodes[node].size / 2;
+    bool blocked = this->nodes[node].blocked;
+
+    std::array<int, 4> children;
+    children[0] = this->newNode(row, col, half, node, blocked);
+    children[1] = this->newNode(row, col + half, half, node, blocked);
+    children[2] = this->newNode(row + half, col, half, node, blocked);
+    children[3] = this->newNode(row + half, col + half, half, node, blocked);
+    this->nodes[node].children = children;
+}
+
+// Delete the vertex of a leaf and its edges
+void QuadtreeEnvironment::removeVertex(int node) {
+    Vertex<QuadCell> *vertex = this->nodes[node].vertex;
+    if (vertex == nullptr) {
+        return;
+    }
+
+    AdjacencyListGraph<QuadCell, float> *graph = this->getGraph();
+    std::vector<Edge<float>*> incident = *graph->outgoingEdges(vertex);
+    incident.insert(incident.end(), graph->incomingEdges(vertex)->begin(), graph->incomingEdges(vertex)->end());
+
+    graph->detachVertex(vertex);
+    for (Edge<float> *edge : incident) {
+        delete edge;
+    }
+    delete vertex;
+    this->nodes[node].vertex = nullptr;
+}
+
+// Collect the open leaves under a node, creating a vertex for each one that doesn't have one
+void QuadtreeEnvironment::collectLeaves(int node, std::vector<int> *leaves) {
+    if (this->nodes[node].children[0] != -1) {
+        for (int child : this->nodes[node].children) {
+            this->collectLeaves(child, leaves);
+        }
+        return;
+    }
+
+    if (!this->nodes[node].blocked) {
+        if (this->nodes[node].vertex == nullptr) {
+            this->nodes[node].vertex = this->getGraph()->insertVertex(QuadCell(this->nodes[node].row, this->nodes[node].column, this->nodes[node].size));
+        }
+        leaves->push_back(node);
+    }
+}
+
+// Collect the open leaves touching each side of a leaf, whatever their size
+void QuadtreeEnvironment::neighbors(int node, std::vector<int> *leaves) {
+    int row = this->nodes[node].row;
+    int col = this->nodes[node].column;
+    int size = this->nodes[node].size;
+    int rootSize = this->nodes[0].size;
+
+    // Walk along each side, skipping past each neighbour found
+    for (int side = 0; side < 4; side++) {
+        int fixed = side == 0 ? row - 1 : side == 1 ? col - 1 : side == 2 ? col + size : row + size;
+        if (fixed < 0 || fixed >= rootSize) {
+            continue;
+        }
+
+        bool horizontal = side == 0 || side == 3;
+        for (int i = horizontal ? col : row; i < (horizontal ? col : row) + size;) {
+            int neighbor = horizontal ? this->leafAt(fixed, i) : this->leafAt(i, fixed);
+            if (!this->nodes[neighbor].blocked) {
+                leaves->push_back(neighbor);
+            }
+            i = (horizontal ? this->nodes[neighbor].column : this->nodes[neighbor].row) + this->nodes[neighbor].size;
+        }
+    }
+}
+
+// Connect newly created leaves to their neighbours in both directions (the cost is the distance between block centers)
+void QuadtreeEnvironment::connect(const std::vector<int> &leaves) {
+    AdjacencyListGraph<QuadCell, float> *graph = this->getGraph();
+    std::vector<int> created = leaves;
+    std::sort(created.begin(), created.end());
+
+    std::vector<int> adjacent;
+    for (int node : leaves) {
+        Vertex<QuadCell> *vertex = this->nodes[node].vertex;
+        sf::Vector2f center = this->localize(vertex);
+
+        adjacent.clear();
+        this->neighbors(node, &adjacent);
+        for (int neighbor : adjacent) {
+            Vertex<QuadCell> *other = this->nodes[neighbor].vertex;
+            sf::Vector2f otherCenter = this->localize(other);
+            float cost = std::hypot(otherCenter.x - center.x, otherCenter.y - center.y);
+
+            // New neighbours add the edge back themselves
+            graph->insertEdge(vertex, other, cost);
+            if (!std::binary_search(created.begin(), created.end(), neighbor)) {
+                graph->insertEdge(other, vertex, cost);
+            }
+        }
+    }
+
+    this->invalidateGraph();
+}
+
+// Quantize a given environment position to the block containing it (or nullptr if it is blocked or off of the grid)
+Vertex<QuadCell> *QuadtreeEnvironment::quantize(sf::Vector2f position) {
+    int column = position.x / this->tileWidth;
+    int row = position.y / this->tileHeight;
+    if (position.x < 0 || position.y < 0 || row >= this->yTiles || column >= this->xTiles) {
+        return nullptr;
+    }
+
+    return this->nodes[this->leafAt(row, column)].vertex;
+}
+
+// Localize a given block to its center
+sf::Vector2f QuadtreeEnvironment::localize(Vertex<QuadCell> *vertex) {
+    QuadCell element = vertex->getElement();
+    return sf::Vector2f((element.column + element.size / 2.0f) * this->tileWidth, (element.row + element.size / 2.0f) * this->tileHeight);
+}
+
+// Return true if a tile is blocked or off of the grid
+bool QuadtreeEnvironment::isObstacle(int row, int col) {
+    if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles) {
+        return true;
+    }
+    return this->nodes[this->leafAt(row, col)].blocked;
+}
+
+// Get the block covering a tile (or nullptr if the tile is blocked or off of the grid)
+Vertex<QuadCell> *QuadtreeEnvironment::getVertex(int row, int col) {
+    if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles) {
+        return nullptr;
+    }
+    return this->nodes[this->leafAt(row, col)].vertex;
+}
+
+// Block or open a tile, rebuilding only the part of the tree and graph around it
+void QuadtreeEnvironment::setCellBlocked(int row, int col, bool blocked) {
+    if (row < 0 || row >= this->yTiles || col < 0 || col >= this->xTiles || this->isObstacle(row, col) == blocked) {
+        return;
+    }
+
+    // Split the leaf covering the tile down to the tile itself
+    int leaf = this->leafAt(row, col);
+    this->removeVertex(leaf);
+    int node = leaf;
+    while (this->nodes[node].size > 1) {
+        this->split(node);
+        node = this->leafAt(row, col);
+    }
+    this->nodes[node].blocked = blocked;
+
+    // Collapse ancestors whose four children now agree
+    int changed = leaf;
+    int parent = this->nodes[node].parent;
+    while (parent != -1) {
+        bool uniform = true;
+        for (int child : this->nodes[parent].children) {
+            if (this->nodes[child].children[0] != -1 || this->nodes[child].blocked != blocked) {
+                uniform = false;
+            }
+        }
+        if (!uniform) {
+            break;
+        }
+
+        for (int child : this->nodes[parent].children) {
+            this->removeVertex(child);
+            this->freeNodes.push_back(child);
+        }
+        this->nodes[parent].children = {-1, -1, -1, -1};
+        this->nodes[parent].blocked = blocked;
+        if (this->nodes[parent].size > this->nodes[changed].size) {
+            changed = parent;
+        }
+        parent = this->nodes[parent].parent;
+    }
+
+    // Every open leaf under the changed node is new
+    std::vector<int> leaves;
+    this->collectLeaves(changed, &leaves);
+    this->connect(leaves);
+    this->invalidateGraph();
+}
@@ -0,0 +1,75 @@
+#ifndef QUADTREE_ENVIRONMENT
+#define QUADTREE_ENVIRONMENT
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+#include "environment.hpp"
+
+// QuadCell class represents a vertex in a quadtree environment (a square block of open tiles)
+class QuadCell {
+    public:
+        int row;    // Top row of the block
+        int column; // Left column of the block
+        int size;   // Side length of the block in tiles
+
+        // Default constructor for a block
+        QuadCell() {}
+
+        // Constructor that sets the top-left tile and size
+        QuadCell(int row, int col, int size) {
+            this->row = row;
+            this->column = col;
+            this->size = size;
+        }
+};
+
+// QuadNode represents a node of the quadtree (leaves are blocks of tiles that are all open or all blocked)
+struct QuadNode {
+    int row;
+    int column;
+    int size;
+    int parent;
+    std::array<int, 4> children;      // Top left, top right, bottom left, bottom right (-1 for leaves)
+    bool blocked;
+    Vertex<QuadCell> *vertex = nullptr; // Vertex of open leaves
+};
+
+// QuadtreeEnvironment class represents an environment whose open space is collapsed into the largest square blocks a quadtree allows
+//
+// Open leaves are the vertices of the graph, and leaves that touch along a side are connected both ways with the
+// distance between their centers as the cost. Tiles outside of the grid count as blocked.
+class QuadtreeEnvironment : public Environment<QuadCell, float> {
+    private:
+        float tileWidth;
+        float tileHeight;
+
+        int xTiles;
+        int yTiles;
+
+        // Nodes of the tree (the root is node 0, and freed nodes are reused)
+        std::vector<QuadNode> nodes;
+        std::vector<int> freeNodes;
+
+        int newNode(int row, int col, int size, int parent, bool blocked);
+        void build(int node, GridEnvironment *grid);
+        int leafAt(int row, int col);
+        void split(int node);
+        void removeVertex(int node);
+        void collectLeaves(int node, std::vector<int> *leaves);
+        void neighbors(int node, std::vector<int> *leaves);
+        void connect(const std::vector<int> &leaves);
+
+    public:
+        QuadtreeEnvironment(int xTiles, int yTiles, int width, int height, GridEnvironment *grid = nullptr);
+        ~QuadtreeEnvironment();
+
+        Vertex<QuadCell> *quantize(sf::Vector2f position);
+        sf::Vector2f localize(Vertex<QuadCell> *vertex);
+
+        bool isObstacle(int row, int col);
+        void setCellBlocked(int row, int col, bool blocked);
+        Vertex<QuadCell> *getVertex(int row, int col);
+};
+
+#endif
@@ -57,34 +57,6 @@ class IsAtMazeEnd : public Decision {
 SceneA::SceneA() {
     srand(time(NULL));
 
-    // String representation of the maze
-    std::vector<std::string> mazeString;
-
-    mazeString.push_back("  xxxxxxxxxxxxx");
-    mazeString.push_back("x     x xxx   x");
-    mazeString.push_back("x           x x");
-    mazeString.push_back("xxxxx xxxxxxx x");
-    mazeString.push_back("x     x       x");
-    mazeString.push_back("x xxx x xxx x x");
-    mazeString.push_back("x   x x     x x");
-    mazeString.push_back("xxxxxxx xxxxxxx");
-    mazeString.push_back("x       x     x");
-    mazeString.push_back("x x x xxxxx x x");
-    mazeString.push_back("x x x   x   x x");
-    mazeString.push_back("x xxxxxxx xxx x");
-    mazeString.push_back("x       x x   x");
-    mazeString.push_back("x x x xxxxxxx x");
-    mazeString.push_back("x x x         x");
-    mazeString.push_back("xxx x x  xxxx x");
-    mazeString.push_back("x x x xxxx  x x");
-    mazeString.push_back("x xxxxx  x  x x");
-    mazeString.push_back("x             x");
-    mazeString.push_back("x xxxxxxxxxxxxx");
-    mazeString.push_back("x   x   x   x x");
-    mazeString.push_back("xxx x x x      ");
-    mazeString.push_back("x     x        ");
-    mazeString.push_back("xxxxxxxxxxx    ");
-
     // Settings for the game engine
     Settings settings = Settings();
     settings.background = sf::Color::White;
@@ -102,6 +74,7 @@ SceneA::SceneA() {
     settings.breadcrumbsPerEntity = 20;
     settings.breadcrumbRadius = 5.0f;
     settings.timePerDecision = sf::seconds(1);
+    settings.navigation = Navigation::NavMesh;
 
     // Setup the mouse capture
     Mouse mouse = Mouse(settings.timePerFrame, settings.timePerFrame.asSeconds() * 15);
@@ -228,17 +201,13 @@ SceneA::SceneA() {
     engine.newEntity(&character);
 
     // Create a maze
-    for (std::vector<std::string>::size_type row = 0; row < mazeString.size(); row++) {
-        for (std::vector<std::string>::size_type col = 0; col < mazeString.at(0).size(); col++) {
-            if (mazeString.at(row).at(col) == 'x') {
-                GridObstacle *o = new GridObstacle(Grid((int) row, (int) col + (32 - 15)));
-                o->setTexture(obstacleTexture);
-                o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-                engine.newObstacle(o);
-            }
-        }
+    if (!engine.loadMap("./assets/sceneA.map", obstacleTexture)) {
+        exit(EXIT_FAILURE);
     }
 
+    // The layout is fixed from here on, so precompute which tiles can see each other
+    engine.getEnvironment()->buildVisibility();
+
     // Start the engine
     this->engine->start();
 }
@@ -8,6 +8,7 @@
 #include "../steering/behaviors.hpp"
 #include "../utils/graph/graph.hpp"
 #include "../utils/graph/vertex.hpp"
+#include "../utils/algorithm/next-hop-table.hpp"
 #include "../environment/environment.hpp"
 #include "../utils/tree/behavior-tree/behavior-tree.hpp"
 
@@ -219,8 +220,8 @@ class PathfindToPatrolPoint : public BehaviorTreeNode {
         }
 };
 
-// Pathfind to a random point
-class PathfindToRandomPoint : public BehaviorTreeNode {
+// Travel the waypoint graph, routed by its next-hop table
+class PathfindAlongWaypoints : public BehaviorTreeNode {
     public:
         Engine *engine;
 
@@ -228,13 +229,13 @@ class PathfindToRandomPoint : public BehaviorTreeNode {
         Arrive arrive = Arrive(5.0f, 10.0f, 40.0f, 0.3f);
         EuclideanHeuristic<int> heuristic = EuclideanHeuristic<int>();
         AlignToVelocity align = AlignToVelocity(5.0f, 10.0f, 0.1f, Align(8.0f, 30.0f, 180.0f, 0.01f));
-        PathfindToRandomPosition *pathfind;
+        PathfindAlongWaypointGraph *pathfind;
         std::vector<WeightedBehavior> behaviors;
 
-        PathfindToRandomPoint(Engine *engine, std::vector<sf::Vector2f*> *patrolPoints) {
+        PathfindAlongWaypoints(Engine *engine, AdjacencyListGraph<Grid<int>, int> *waypointGraph, NextHopTable<Grid<int>, int> *waypointTable) {
             this->engine = engine;
 
-            this->pathfind = new PathfindToRandomPosition(this->engine, &this->arrive, &this->heuristic, 0.2, patrolPoints);
+            this->pathfind = new PathfindAlongWaypointGraph(this->engine, &this->arrive, &this->heuristic, 0.2, waypointGraph, waypointTable, sf::Vector2f(60, 44));
             this->pathfind->weight = 1;
 
             this->align.weight = 1;
@@ -243,11 +244,11 @@ class PathfindToRandomPoint : public BehaviorTreeNode {
             this->behaviors.push_back(this->align);
         }
 
-        ~PathfindToRandomPoint() {
+        ~PathfindAlongWaypoints() {
             delete this->pathfind;
         }
 
-        // Pathfind to the next patrol point
+        // Travel to the next waypoint
         void *run(EnvironmentParameters *environment) {
             environment->character->setCurrentAction(this->name);
 
@@ -402,25 +403,15 @@ SceneB::SceneB() {
     monsterTree.addNode(&isCharacterNotInvisible, onPatrolNode, true);
     monsterTree.addNode(&pathfindToPatrolPoint, onPatrolNode, true);
 
+    // Load the character's waypoint graph, along with the next-hop table that routes it (built and saved the first time)
+    AdjacencyListGraph<Grid<int>, int> waypointGraph = AdjacencyListGraph<Grid<int>, int>(true);
+    readGridGraphFromCSV(&waypointGraph, "./assets/small-graph-grid.csv");
+    NextHopTable<Grid<int>, int> waypointTable = NextHopTable<Grid<int>, int>(&waypointGraph);
+    loadOrBuildNextHopTable(&waypointTable, "./assets/small-graph-grid.csv");
+
     // Create behaviors for the character
-    sf::Vector2f pos01 = sf::Vector2f(40, 40);
-    sf::Vector2f pos02 = sf::Vector2f(40, 41);
-    sf::Vector2f pos03 = sf::Vector2f(40, 42);
-    sf::Vector2f pos06 = sf::Vector2f(40, 400);
-    sf::Vector2f pos07 = sf::Vector2f(40, 401);
-    sf::Vector2f pos08 = sf::Vector2f(40, 402);
-    std::vector<sf::Vector2f*> findPoints;
-    findPoints.push_back(&pos1);
-    findPoints.push_back(&pos5);
-    findPoints.push_back(&pos01);
-    findPoints.push_back(&pos02);
-    findPoints.push_back(&pos03);
-    findPoints.push_back(&pos06);
-    findPoints.push_back(&pos07);
-    findPoints.push_back(&pos08);
-
-    PathfindToRandomPoint pathfindToRandomPoint = PathfindToRandomPoint(&engine, &findPoints);
-    pathfindToRandomPoint.name = "Pathfinding to random point";
+    PathfindAlongWaypoints pathfindAlongWaypoints = PathfindAlongWaypoints(&engine, &waypointGraph, &waypointTable);
+    pathfindAlongWaypoints.name = "Pathfinding along waypoints";
 
     MakeCharacterDoNothing makeCharacterDoNothing;
     makeCharacterDoNothing.name = "Make character do nothing";
@@ -438,7 +429,7 @@ SceneB::SceneB() {
 
     // Add children to the pathfind sequence node
     characterTree.addNode(&isCharacterNotInvisible, pathfindNode, true);
-    characterTree.addNode(&pathfindToRandomPoint, pathfindNode, true);
+    characterTree.addNode(&pathfindAlongWaypoints, pathfindNode, true);
 
     // Load the sprite assets
     sf::Texture boidTexture;
@@ -478,103 +469,8 @@ SceneB::SceneB() {
     //engine.addRecorder("./assets/monster-states.csv", &monster);
 
     // Create walls and obstacles
-    for (int row = 0; row < settings.yTiles / 2 - 2; row++) {
-        for (int col = 4; col < 6; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = settings.yTiles / 2 + 2; row < settings.yTiles; row++) {
-        for (int col = 4; col < 6; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 13; row < 15; row++) {
-        for (int col = 18; col < 22; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 10; row < 12; row++) {
-        for (int col = 26; col < 28; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 16; row < 22; row++) {
-        for (int col = 12; col < 14; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 20; row < 22; row++) {
-        for (int col = 25; col < 31; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 6; row < 8; row++) {
-        for (int col = 20; col < 22; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 11; row < 13; row++) {
-        for (int col = 9; col < 11; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 4; row < 6; row++) {
-        for (int col = 9; col < 15; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 8; row < 10; row++) {
-        for (int col = 26; col < 31; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 4; row < 7; row++) {
-        for (int col = 29; col < 31; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
+    if (!engine.loadMap("./assets/sceneB.map", obstacleTexture)) {
+        exit(EXIT_FAILURE);
     }
 
     // Start the engine
@@ -135,21 +135,24 @@ class IsCharacterInHostileZone : public BehaviorTreeNode {
         }
 };
 
-// Pathfind to the character
+// Number of decisions monsters plan and reserve ahead of themselves
+const int MONSTER_WINDOW = 8;
+
+// Pathfind to the character, planning around the other monsters
 class PathfindToCharacter : public BehaviorTreeNode {
     public:
         Engine *engine;
         
-        // Objects relating to pathfinding
-        Arrive arrive = Arrive(5.0f, 10.0f, 50.0f, 0.3f);
+        // Objects relating to pathfinding (monsters move a tile per decision, the pace their reservations are made at)
+        Arrive arrive = Arrive(5.0f, 10.0f, 100.0f, 0.1f);
         EuclideanHeuristic<int> heuristic = EuclideanHeuristic<int>();
         AlignToVelocity align = AlignToVelocity(5.0f, 10.0f, 0.1f, Align(8.0f, 30.0f, 180.0f, 0.01f));
-        PathfindToPosition *pathfindToCharacter;
+        CooperativePathfindToPosition *pathfindToCharacter;
 
         PathfindToCharacter(Engine *engine) {
             this->engine = engine;
 
-            this->pathfindToCharacter = new PathfindToPosition(this->engine, &this->arrive, &this->heuristic, 0.2, sf::Vector2f(0, 0));
+            this->pathfindToCharacter = new CooperativePathfindToPosition(this->engine, &this->arrive, &this->heuristic, MONSTER_WINDOW, sf::Vector2f(0, 0));
             this->pathfindToCharacter->weight = 1;
 
             align.weight = 1;
@@ -177,22 +180,25 @@ class PathfindToCharacter : public BehaviorTreeNode {
         }
 };
 
-// Pathfind to the next patrol point
+// Pathfind to the next patrol point, planning around the other monsters
 class PathfindToPatrolPoint : public BehaviorTreeNode {
     public:
         Engine *engine;
+        std::vector<sf::Vector2f*> *patrolPoints;
+        int patrolIndex = 0;
 
-        // Pathfinding objects
-        Arrive arrive = Arrive(5.0f, 10.0f, 40.0f, 0.3f);
+        // Pathfinding objects (monsters move a tile per decision, the pace their reservations are made at)
+        Arrive arrive = Arrive(5.0f, 10.0f, 100.0f, 0.1f);
         EuclideanHeuristic<int> heuristic = EuclideanHeuristic<int>();
         AlignToVelocity align = AlignToVelocity(5.0f, 10.0f, 0.1f, Align(8.0f, 30.0f, 180.0f, 0.01f));
-        PathfindToMultiplePosition *pathfind;
+        CooperativePathfindToPosition *pathfind;
         std::vector<WeightedBehavior> behaviors;
 
         PathfindToPatrolPoint(Engine *engine, std::vector<sf::Vector2f*> *patrolPoints) {
             this->engine = engine;
+            this->patrolPoints = patrolPoints;
 
-            this->pathfind = new PathfindToMultiplePosition(this->engine, &this->arrive, &this->heuristic, 0.2, patrolPoints);
+            this->pathfind = new CooperativePathfindToPosition(this->engine, &this->arrive, &this->heuristic, MONSTER_WINDOW, *patrolPoints->at(0));
             this->pathfind->weight = 1;
 
             this->align.weight = 1;
@@ -211,7 +217,14 @@ class PathfindToPatrolPoint : public BehaviorTreeNode {
 
             if (((Boolean*) environment->gameState->getStateVariable("was_spinning"))->is()) {
                 this->engine->setStateVariable("was_spinning", &BOOL_FALSE);
-                this->pathfind->reset();
+                this->pathfind->reset(*this->patrolPoints->at(this->patrolIndex));
+            }
+
+            // Move on to the next patrol point once the monster is on its tile
+            GridEnvironment *grid = this->engine->getEnvironment();
+            if (grid->quantize(environment->character->getPosition()) == grid->quantize(*this->patrolPoints->at(this->patrolIndex))) {
+                this->patrolIndex = (this->patrolIndex + 1) % this->patrolPoints->size();
+                this->pathfind->reset(*this->patrolPoints->at(this->patrolIndex));
             }
 
             environment->character->setBehaviors(this->behaviors);
@@ -220,8 +233,8 @@ class PathfindToPatrolPoint : public BehaviorTreeNode {
         }
 };
 
-// Pathfind to a random point
-class PathfindToRandomPoint : public BehaviorTreeNode {
+// Pathfind to the nearest point that hasn't been visited yet
+class PathfindToNearestPoint : public BehaviorTreeNode {
     public:
         Engine *engine;
 
@@ -229,13 +242,13 @@ class PathfindToRandomPoint : public BehaviorTreeNode {
         Arrive arrive = Arrive(5.0f, 10.0f, 40.0f, 0.3f);
         EuclideanHeuristic<int> heuristic = EuclideanHeuristic<int>();
         AlignToVelocity align = AlignToVelocity(5.0f, 10.0f, 0.1f, Align(8.0f, 30.0f, 180.0f, 0.01f));
-        PathfindToRandomPosition *pathfind;
+        PathfindToNearestPosition *pathfind;
         std::vector<WeightedBehavior> behaviors;
 
-        PathfindToRandomPoint(Engine *engine, std::vector<sf::Vector2f*> *patrolPoints) {
+        PathfindToNearestPoint(Engine *engine, std::vector<sf::Vector2f*> *patrolPoints) {
             this->engine = engine;
 
-            this->pathfind = new PathfindToRandomPosition(this->engine, &this->arrive, &this->heuristic, 0.2, patrolPoints);
+            this->pathfind = new PathfindToNearestPosition(this->engine, &this->arrive, &this->heuristic, 0.2, patrolPoints);
             this->pathfind->weight = 1;
 
             this->align.weight = 1;
@@ -244,7 +257,7 @@ class PathfindToRandomPoint : public BehaviorTreeNode {
             this->behaviors.push_back(this->align);
         }
 
-        ~PathfindToRandomPoint() {
+        ~PathfindToNearestPoint() {
             delete this->pathfind;
         }
 
@@ -398,6 +411,17 @@ SceneC::SceneC() {
 
     makeDecisionTree(packets, attributes, rootMultiNode, &createdTree);
 
+    // The second monster runs its own copy of the tree, so each keeps its own path and reservations
+    DecisionTree secondTree;
+
+    ParentDecisionMakingNode secondDecision = ParentDecisionMakingNode(&engine, &patrolPoints);
+    Vertex<AbstractDMNode*> *secondDecisionNode = secondTree.addRoot(&secondDecision);
+
+    DecisionMulti secondMulti = DecisionMulti();
+    Vertex<AbstractDMNode*> *secondMultiNode = secondTree.insertNode(&secondMulti, secondDecisionNode, true);
+
+    makeDecisionTree(packets, attributes, secondMultiNode, &secondTree);
+
     // Setup all action/condition nodes
     IsMonsterColliding isMonsterColliding;
     MakeCharacterInvisible makeCharacterInvisible;
@@ -412,23 +436,15 @@ SceneC::SceneC() {
 
     // Create behaviors for the character
     sf::Vector2f pos01 = sf::Vector2f(40, 40);
-    sf::Vector2f pos02 = sf::Vector2f(40, 41);
-    sf::Vector2f pos03 = sf::Vector2f(40, 42);
     sf::Vector2f pos06 = sf::Vector2f(40, 400);
-    sf::Vector2f pos07 = sf::Vector2f(40, 401);
-    sf::Vector2f pos08 = sf::Vector2f(40, 402);
     std::vector<sf::Vector2f*> findPoints;
     findPoints.push_back(&pos1);
     findPoints.push_back(&pos5);
     findPoints.push_back(&pos01);
-    findPoints.push_back(&pos02);
-    findPoints.push_back(&pos03);
     findPoints.push_back(&pos06);
-    findPoints.push_back(&pos07);
-    findPoints.push_back(&pos08);
 
-    PathfindToRandomPoint pathfindToRandomPoint = PathfindToRandomPoint(&engine, &findPoints);
-    pathfindToRandomPoint.name = "Pathfinding to random point";
+    PathfindToNearestPoint pathfindToNearestPoint = PathfindToNearestPoint(&engine, &findPoints);
+    pathfindToNearestPoint.name = "Pathfinding to nearest point";
 
     MakeCharacterDoNothing makeCharacterDoNothing;
     makeCharacterDoNothing.name = "Make character do nothing";
@@ -446,7 +462,7 @@ SceneC::SceneC() {
 
     // Add children to the pathfind sequence node
     characterTree.addNode(&isCharacterNotInvisible, pathfindNode, true);
-    characterTree.addNode(&pathfindToRandomPoint, pathfindNode, true);
+    characterTree.addNode(&pathfindToNearestPoint, pathfindNode, true);
 
     // Load the sprite assets
     sf::Texture boidTexture;
@@ -484,105 +500,21 @@ SceneC::SceneC() {
     monster.setDecisionMakingTree(&createdTree);
     engine.newEntity(&monster);
 
-    // Create walls and obstacles
-    for (int row = 0; row < settings.yTiles / 2 - 2; row++) {
-        for (int col = 4; col < 6; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = settings.yTiles / 2 + 2; row < settings.yTiles; row++) {
-        for (int col = 4; col < 6; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 13; row < 15; row++) {
-        for (int col = 18; col < 22; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 10; row < 12; row++) {
-        for (int col = 26; col < 28; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 16; row < 22; row++) {
-        for (int col = 12; col < 14; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
+    // Create a second monster that shares the corridors with the first
+    Entity secondMonster = Entity(sf::Vector2f(300, 60));
+    secondMonster.setTexture(monsterTexture);
+    secondMonster.scale(sf::Vector2f(0.3, 0.3));
+    secondMonster.setOrigin(secondMonster.getLocalBounds().width / 2, secondMonster.getLocalBounds().height / 2);
+    secondMonster.setDecisionMakingTree(&secondTree);
+    engine.newEntity(&secondMonster);
 
-    for (int row = 20; row < 22; row++) {
-        for (int col = 25; col < 31; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 6; row < 8; row++) {
-        for (int col = 20; col < 22; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 11; row < 13; row++) {
-        for (int col = 9; col < 11; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 4; row < 6; row++) {
-        for (int col = 9; col < 15; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
-
-    for (int row = 8; row < 10; row++) {
-        for (int col = 26; col < 31; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
+    // Create walls and obstacles
+    if (!engine.loadMap("./assets/sceneC.map", obstacleTexture)) {
+        exit(EXIT_FAILURE);
     }
 
-    for (int row = 4; row < 7; row++) {
-        for (int col = 29; col < 31; col++) {
-            GridObstacle *o = new GridObstacle(Grid(row, col));
-            o->setTexture(obstacleTexture);
-            o->scale(sf::Vector2f(640 / settings.xTiles / 10, 480 / settings.yTiles / 10));
-            engine.newObstacle(o);
-        }
-    }
+    // The layout is fixed from here on, so precompute which tiles can see each other
+    engine.getEnvironment()->buildVisibility();
 
     // Start the engine
     this->engine->start();
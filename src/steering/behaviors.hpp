@@ -2,13 +2,16 @@
 #define BEHAVIORS
 
 #include <math.h>
+#include <algorithm>
 #include <random>
 #include <iostream>
+#include <limits>
 #include "steering.hpp"
 #include "../utils/vmath/vmath.hpp"
 #include "../engine/engine.hpp"
 #include "../utils/algorithm/heuristic.hpp"
 #include "../utils/graph/graph.hpp"
+#include "../utils/algorithm/next-hop-table.hpp"
 
 // AlignToVelocity behavior, which aligns an orientation to direction of velocity
 class AlignToVelocity : public WeightedBehavior {
@@ -304,13 +307,81 @@ class ConstantRotationMatch : public WeightedBehavior {
 };
 
 
+// PathFollower holds a path as the positions it passes through and tracks the segment a character is on
+// The path is converted once when it is set, and follow only looks at the current and next segments
+class PathFollower {
+    private:
+        std::vector<sf::Vector2f> waypoints;
+        int segment = 0;
+
+        // Get the distance from a position to a segment of the path, and how far along the segment its projection falls (0 at the start, 1 at the end)
+        float distanceToSegment(int index, sf::Vector2f position, float *along) {
+            sf::Vector2f start = this->waypoints.at(index);
+            sf::Vector2f direction = this->waypoints.at(index + 1) - start;
+            float lengthSquared = Vmath::dotProduct(direction, direction);
+
+            *along = lengthSquared > 0 ? Vmath::dotProduct(position - start, direction) / lengthSquared : 1;
+            float clamped = std::max(0.0f, std::min(1.0f, *along));
+            return Vmath::length(start + direction * clamped - position);
+        }
+
+    public:
+        // Follow a path of edges through the centers of the tiles it visits
+        void setPath(GridEnvironment *environment, const std::vector<Edge<int>*> &path) {
+            this->waypoints.clear();
+            this->segment = 0;
+            if (path.size() == 0) {
+                return;
+            }
+
+            this->waypoints.reserve(path.size() + 1);
+            this->waypoints.push_back(environment->localizeEndpoint(path.at(0), 0));
+            for (Edge<int> *edge : path) {
+                this->waypoints.push_back(environment->localizeEndpoint(edge, 1));
+            }
+        }
+
+        // Follow a path given as the positions it passes through (such as one from Engine::pathfindWaypoints)
+        void setWaypoints(const std::vector<sf::Vector2f> &waypoints) {
+            this->waypoints = waypoints;
+            this->segment = 0;
+        }
+
+        // Return true if there is no path to follow
+        bool isEmpty() {
+            return this->waypoints.size() < 2;
+        }
+
+        // Return true if the character is on the last segment of the path
+        bool onLastSegment() {
+            return this->waypoints.size() >= 2 && this->segment + 2 == (int) this->waypoints.size();
+        }
+
+        // Move on past segments a position has passed the end of (or is closer to the next one than), and return the end of the segment it is on
+        sf::Vector2f follow(sf::Vector2f position) {
+            while (this->segment + 2 < (int) this->waypoints.size()) {
+                float along;
+                float nextAlong;
+                float current = this->distanceToSegment(this->segment, position, &along);
+                float next = this->distanceToSegment(this->segment + 1, position, &nextAlong);
+                if (along < 1 && current <= next) {
+                    break;
+                }
+                this->segment++;
+            }
+
+            return this->waypoints.at(this->segment + 1);
+        }
+};
+
 // PathfindToMouse pathfinds to each mouse click
 class PathfindToMouse : public WeightedBehavior {
     private:
         // Variables for Pathfind
         sf::Vector2f lastClicked;
         std::vector<Edge<int>*> path;
-        int currentIndex = 0;
+        PathFollower follower;
+        int ticket = -1;
 
         // Attributes
         float predictTime;
@@ -333,10 +404,18 @@ class PathfindToMouse : public WeightedBehavior {
                 } else if (this->lastClicked != clicked) {
                     // The user has clicked somewhere new
                     this->lastClicked = clicked;
-                    this->currentIndex = 0;
 
-                    // Pathfind to that location (if it is possible)
-                    this->path = engine->pathfind(character.position, this->lastClicked, heuristic);
+                    // Request a path to that location, following the old path until it resolves
+                    if (this->ticket != -1) {
+                        engine->cancelPath(this->ticket);
+                    }
+                    this->ticket = engine->requestPath(character.position, this->lastClicked, heuristic, engine->pathPriority(character.position), "PathfindToMouse");
+                }
+
+                // Switch to the new path once it has resolved
+                if (this->ticket != -1 && engine->pollPath(this->ticket, &this->path)) {
+                    this->ticket = -1;
+                    this->follower.setPath(engine->getEnvironment(), this->path);
                 }
 
                 // Don't path follow empty paths
@@ -344,35 +423,20 @@ class PathfindToMouse : public WeightedBehavior {
                     return Accelerations();
                 }
 
-                // Find the characters future position
+                // Head for the end of the path segment the character's future position is on
                 sf::Vector2f futurePosition = character.position + character.linearVelocity * this->predictTime;
-
-                // Find the closest point on the path to the character's future position
-                float minDistance = std::numeric_limits<float>::max();
-                int minIndex = this->currentIndex;
-
-                for (typename std::vector<Edge<int>*>::size_type i = this->currentIndex; i < this->path.size(); i++) {
-                    float distance = Vmath::length(engine->getEnvironment()->localizeEndpoint(this->path.at(i), 0) - futurePosition);
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        minIndex = i;
-                    }
-                }
-                this->currentIndex = minIndex;
-
-                params.target.position = engine->getEnvironment()->localizeEndpoint(this->path.at(this->currentIndex), 1);
+                params.target.position = this->follower.follow(futurePosition);
                 return behavior->find(params);
             };
         }
 };
 
-// PathfindToPosition pathfinds to a given position
+// PathfindToPositionOld pathfinds to a given position right away, on whichever environment the engine's settings navigate
 class PathfindToPositionOld : public WeightedBehavior {
     private:
         // Variables for Pathfind
         sf::Vector2f targetPosition;
-        std::vector<Edge<int>*> path;
-        int currentIndex = 0;
+        PathFollower follower;
 
         // Attributes
         float predictTime;
@@ -388,32 +452,16 @@ class PathfindToPositionOld : public WeightedBehavior {
                 params.character = character;
 
                 // Pathfind to that location (if it is possible)
-                if (this->path.size() == 0) {
-                    this->currentIndex = 0;
-
-                    this->path = engine->pathfind(character.position, this->targetPosition, heuristic);
-                    if (this->path.size() == 0) {
+                if (this->follower.isEmpty()) {
+                    this->follower.setWaypoints(engine->pathfindWaypoints(character.position, this->targetPosition, heuristic, "PathfindToPositionOld"));
+                    if (this->follower.isEmpty()) {
                         return Accelerations();
                     }
                 }
 
-                // Find the characters future position
+                // Head for the end of the path segment the character's future position is on
                 sf::Vector2f futurePosition = character.position + character.linearVelocity * this->predictTime;
-
-                // Find the closest point on the path to the character's future position
-                float minDistance = std::numeric_limits<float>::max();
-                int minIndex = this->currentIndex;
-
-                for (typename std::vector<Edge<int>*>::size_type i = this->currentIndex; i < this->path.size(); i++) {
-                    float distance = Vmath::length(engine->getEnvironment()->localizeEndpoint(this->path.at(i), 0) - futurePosition);
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        minIndex = i;
-                    }
-                }
-                this->currentIndex = minIndex;
-
-                params.target.position = engine->getEnvironment()->localizeEndpoint(this->path.at(this->currentIndex), 1);
+                params.target.position = this->follower.follow(futurePosition);
                 return behavior->find(params);
             };
         }
@@ -425,8 +473,9 @@ class PathfindToPosition : public WeightedBehavior {
         // Variables for Pathfind
         sf::Vector2f targetPosition;
         std::vector<Edge<int>*> path;
-        int currentIndex = 0;
+        PathFollower follower;
         bool calculatedPath = false;
+        int ticket = -1;
 
         // Attributes
         float predictTime;
@@ -437,41 +486,83 @@ class PathfindToPosition : public WeightedBehavior {
         PathfindToPosition(Engine *engine, SteeringBehavior *behavior, Heuristic<Grid<int>, int> *heuristic, float predictTime, sf::Vector2f targetPosition) {
             this->predictTime = predictTime;
 
-            // Pathfind to that location (if it is possible)
-            this->currentIndex = 0;
-
             // Set up the behavior function
             this->behavior = [this, engine, behavior, heuristic](Target character) mutable -> Accelerations {
                 Params params;
                 params.character = character;
 
+                // Request a path to the target, following the old path until it resolves
                 if (!this->calculatedPath) {
                     this->calculatedPath = true;
-                    this->currentIndex = 0;
-                    this->path = engine->pathfind(character.position, this->targetPosition, heuristic);
+                    if (this->ticket != -1) {
+                        engine->cancelPath(this->ticket);
+                    }
+                    this->ticket = engine->requestPath(character.position, this->targetPosition, heuristic, engine->pathPriority(character.position), "PathfindToPosition");
+                }
+
+                // Switch to the new path once it has resolved
+                if (this->ticket != -1 && engine->pollPath(this->ticket, &this->path)) {
+                    this->ticket = -1;
+                    this->follower.setPath(engine->getEnvironment(), this->path);
                 }
 
                 if (this->path.size() == 0) {
                     return Accelerations();
                 }
 
-                // Find the characters future position
+                // Head for the end of the path segment the character's future position is on
                 sf::Vector2f futurePosition = character.position + character.linearVelocity * this->predictTime;
+                params.target.position = this->follower.follow(futurePosition);
+                return behavior->find(params);
+            };
+        }
 
-                // Find the closest point on the path to the character's future position
-                float minDistance = std::numeric_limits<float>::max();
-                int minIndex = this->currentIndex;
+        void reset(sf::Vector2f position) {
+            this->calculatedPath = false;
+            this->targetPosition = position;
+        }
+};
 
-                for (typename std::vector<Edge<int>*>::size_type i = this->currentIndex; i < this->path.size(); i++) {
-                    float distance = Vmath::length(engine->getEnvironment()->localizeEndpoint(this->path.at(i), 0) - futurePosition);
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        minIndex = i;
-                    }
+// CooperativePathfindToPosition pathfinds to a given position while planning around other cooperative agents' reservations
+class CooperativePathfindToPosition : public WeightedBehavior {
+    private:
+        // Variables for Pathfind
+        sf::Vector2f targetPosition;
+        std::vector<Vertex<Grid<int>>*> timedPath;
+        int plannedAt = 0;
+        bool calculatedPath = false;
+
+        // Attributes
+        int agent;
+        int window;
+
+    public:
+        CooperativePathfindToPosition(Engine *engine, SteeringBehavior *behavior, Heuristic<Grid<int>, int> *heuristic, int window, sf::Vector2f targetPosition) {
+            this->agent = engine->newCooperativeAgent();
+            this->window = window;
+            this->targetPosition = targetPosition;
+
+            // Set up the behavior function
+            this->behavior = [this, engine, behavior, heuristic](Target character) mutable -> Accelerations {
+                Params params;
+                params.character = character;
+
+                // Replan halfway through the window so our reservations always look ahead (or sooner, if another agent held the rest of the window)
+                int elapsed = engine->getTimestamp() - this->plannedAt;
+                if (!this->calculatedPath || elapsed >= std::max(1, std::min(this->window / 2, (int) this->timedPath.size() - 1))) {
+                    this->calculatedPath = true;
+                    this->plannedAt = engine->getTimestamp();
+                    this->timedPath = engine->pathfindCooperative(this->agent, character.position, this->targetPosition, heuristic, this->window, "CooperativePathfindToPosition");
+                    elapsed = 0;
                 }
-                this->currentIndex = minIndex;
 
-                params.target.position = engine->getEnvironment()->localizeEndpoint(this->path.at(this->currentIndex), 1);
+                if (this->timedPath.size() == 0) {
+                    return Accelerations();
+                }
+
+                // Head for the vertex we have reserved for the next timestep (which is the current vertex when waiting)
+                int index = std::min(elapsed + 1, (int) this->timedPath.size() - 1);
+                params.target.position = engine->getEnvironment()->localize(this->timedPath.at(index));
                 return behavior->find(params);
             };
         }
@@ -489,8 +580,9 @@ class PathfindToMultiplePosition : public WeightedBehavior {
         int positionIndex = 0;
 
         std::vector<Edge<int>*> path;
-        int currentIndex = 0;
+        PathFollower follower;
         bool calculatedPath = false;
+        int ticket = -1;
 
         // Attributes
         float predictTime;
@@ -504,34 +596,83 @@ class PathfindToMultiplePosition : public WeightedBehavior {
                 Params params;
                 params.character = character;
 
-                if (!this->calculatedPath || this->currentIndex + 1 == (int) this->path.size()) {
+                // Request a path to the next target, following the old path until it resolves
+                if (!this->calculatedPath || (this->ticket == -1 && this->follower.onLastSegment())) {
                     this->calculatedPath = true;
-                    this->currentIndex = 0;
+                    if (this->ticket != -1) {
+                        engine->cancelPath(this->ticket);
+                    }
                     this->positionIndex = (this->positionIndex + 1) % targetPositions->size();
-                    this->path = engine->pathfind(character.position, *(targetPositions->at(this->positionIndex)), heuristic);
+                    this->ticket = engine->requestPath(character.position, *(targetPositions->at(this->positionIndex)), heuristic, engine->pathPriority(character.position), "PathfindToMultiplePosition");
+                }
+
+                // Switch to the new path once it has resolved
+                if (this->ticket != -1 && engine->pollPath(this->ticket, &this->path)) {
+                    this->ticket = -1;
+                    this->follower.setPath(engine->getEnvironment(), this->path);
                 }
 
                 if (this->path.size() == 0) {
                     return Accelerations();
                 }
 
-                // Find the characters future position
+                // Head for the end of the path segment the character's future position is on
                 sf::Vector2f futurePosition = character.position + character.linearVelocity * this->predictTime;
+                params.target.position = this->follower.follow(futurePosition);
+                return behavior->find(params);
+            };
+        }
+
+        void reset() {
+            this->calculatedPath = false;
+        }
+};
 
-                // Find the closest point on the path to the character's future position
-                float minDistance = std::numeric_limits<float>::max();
-                int minIndex = this->currentIndex;
+// PathfindToRandomPosition pathfinds to multiple positions
+class PathfindToRandomPosition : public WeightedBehavior {
+    private:
+        // Variables for Pathfind
+
+        std::vector<Edge<int>*> path;
+        PathFollower follower;
+        bool calculatedPath = false;
+        int ticket = -1;
+
+        // Attributes
+        float predictTime;
 
-                for (typename std::vector<Edge<int>*>::size_type i = this->currentIndex; i < this->path.size(); i++) {
-                    float distance = Vmath::length(engine->getEnvironment()->localizeEndpoint(this->path.at(i), 0) - futurePosition);
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        minIndex = i;
+    public:
+        PathfindToRandomPosition(Engine *engine, SteeringBehavior *behavior, Heuristic<Grid<int>, int> *heuristic, float predictTime, std::vector<sf::Vector2f*> *targetPositions) {
+            this->predictTime = predictTime;
+
+            // Set up the behavior function
+            this->behavior = [this, engine, behavior, targetPositions, heuristic](Target character) mutable -> Accelerations {
+                Params params;
+                params.character = character;
+
+                // Request a path to the next target, following the old path until it resolves
+                if (!this->calculatedPath || (this->ticket == -1 && this->follower.onLastSegment())) {
+                    this->calculatedPath = true;
+                    if (this->ticket != -1) {
+                        engine->cancelPath(this->ticket);
                     }
+                    int randomIndex = rand() % targetPositions->size();
+                    this->ticket = engine->requestPath(character.position, *(targetPositions->at(randomIndex)), heuristic, engine->pathPriority(character.position), "PathfindToRandomPosition");
+                }
+
+                // Switch to the new path once it has resolved
+                if (this->ticket != -1 && engine->pollPath(this->ticket, &this->path)) {
+                    this->ticket = -1;
+                    this->follower.setPath(engine->getEnvironment(), this->path);
+                }
+
+                if (this->path.size() == 0) {
+                    return Accelerations();
                 }
-                this->currentIndex = minIndex;
 
-                params.target.position = engine->getEnvironment()->localizeEndpoint(this->path.at(this->currentIndex), 1);
+                // Head for the end of the path segment the character's future position is on
+                sf::Vector2f futurePosition = character.position + character.linearVelocity * this->predictTime;
+                params.target.position = this->follower.follow(futurePosition);
                 return behavior->find(params);
             };
         }
@@ -541,20 +682,22 @@ class PathfindToMultiplePosition : public WeightedBehavior {
         }
 };
 
-// PathfindToRandomPosition pathfinds to multiple positions
-class PathfindToRandomPosition : public WeightedBehavior {
+// PathfindToNearestPosition visits every target position, always heading for the closest one it hasn't visited yet (found in a single search),
+// and starts over once it has visited them all
+class PathfindToNearestPosition : public WeightedBehavior {
     private:
         // Variables for Pathfind
+        std::vector<bool> visited;
 
         std::vector<Edge<int>*> path;
-        int currentIndex = 0;
+        PathFollower follower;
         bool calculatedPath = false;
 
         // Attributes
         float predictTime;
 
     public:
-        PathfindToRandomPosition(Engine *engine, SteeringBehavior *behavior, Heuristic<Grid<int>, int> *heuristic, float predictTime, std::vector<sf::Vector2f*> *targetPositions) {
+        PathfindToNearestPosition(Engine *engine, SteeringBehavior *behavior, Heuristic<Grid<int>, int> *heuristic, float predictTime, std::vector<sf::Vector2f*> *targetPositions) {
             this->predictTime = predictTime;
 
             // Set up the behavior function
@@ -562,40 +705,148 @@ class PathfindToRandomPosition : public WeightedBehavior {
                 Params params;
                 params.character = character;
 
-                if (!this->calculatedPath || this->currentIndex + 1 == (int) this->path.size()) {
+                if (!this->calculatedPath || this->follower.onLastSegment()) {
                     this->calculatedPath = true;
-                    this->currentIndex = 0;
-                    int randomIndex = rand() % targetPositions->size();
-                    this->path = engine->pathfind(character.position, *(targetPositions->at(randomIndex)), heuristic);
+
+                    int reached = -1;
+                    for (int attempt = 0; attempt < 2 && reached == -1; attempt++) {
+                        // Start a new round once every position has been visited (or the ones left can't be reached)
+                        if (attempt == 1 || std::find(this->visited.begin(), this->visited.end(), false) == this->visited.end()) {
+                            this->visited.assign(targetPositions->size(), false);
+                        }
+
+                        // Search for every position left at once
+                        std::vector<sf::Vector2f> candidates;
+                        std::vector<int> candidateIndices;
+                        for (std::vector<sf::Vector2f*>::size_type i = 0; i < targetPositions->size(); i++) {
+                            if (!this->visited.at(i)) {
+                                candidates.push_back(*targetPositions->at(i));
+                                candidateIndices.push_back(i);
+                            }
+                        }
+
+                        int reachedCandidate = -1;
+                        this->path = engine->pathfindToNearest(character.position, candidates, heuristic, &reachedCandidate, "PathfindToNearestPosition");
+                        reached = reachedCandidate == -1 ? -1 : candidateIndices.at(reachedCandidate);
+                    }
+
+                    if (reached != -1) {
+                        this->visited.at(reached) = true;
+                    }
+                    this->follower.setPath(engine->getEnvironment(), this->path);
+
+                    // A position on the character's own tile is reached without moving, so head for the next one on the following frame
+                    if (reached != -1 && this->path.size() == 0) {
+                        this->calculatedPath = false;
+                    }
                 }
 
                 if (this->path.size() == 0) {
                     return Accelerations();
                 }
 
-                // Find the characters future position
+                // Head for the end of the path segment the character's future position is on
                 sf::Vector2f futurePosition = character.position + character.linearVelocity * this->predictTime;
+                params.target.position = this->follower.follow(futurePosition);
+                return behavior->find(params);
+            };
+        }
+
+        void reset() {
+            this->calculatedPath = false;
+        }
+};
+
+// PathfindAlongWaypointGraph travels between random vertices of a static waypoint graph, routed one hop at a time by the graph's next-hop table
+// A waypoint at (row, column) sits at (column * spacing.x, row * spacing.y), and each hop between waypoints is pathfound on the environment
+class PathfindAlongWaypointGraph : public WeightedBehavior {
+    private:
+        // Variables for Pathfind
+        Vertex<Grid<int>> *current = nullptr;
+        Vertex<Grid<int>> *destination = nullptr;
 
-                // Find the closest point on the path to the character's future position
-                float minDistance = std::numeric_limits<float>::max();
-                int minIndex = this->currentIndex;
+        std::vector<Edge<int>*> path;
+        PathFollower follower;
+        bool calculatedPath = false;
+        int ticket = -1;
+
+        // Attributes
+        float predictTime;
 
-                for (typename std::vector<Edge<int>*>::size_type i = this->currentIndex; i < this->path.size(); i++) {
-                    float distance = Vmath::length(engine->getEnvironment()->localizeEndpoint(this->path.at(i), 0) - futurePosition);
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        minIndex = i;
+    public:
+        PathfindAlongWaypointGraph(Engine *engine, SteeringBehavior *behavior, Heuristic<Grid<int>, int> *heuristic, float predictTime, AdjacencyListGraph<Grid<int>, int> *graph, NextHopTable<Grid<int>, int> *table, sf::Vector2f spacing) {
+            this->predictTime = predictTime;
+
+            // Set up the behavior function
+            this->behavior = [this, engine, behavior, heuristic, graph, table, spacing](Target character) mutable -> Accelerations {
+                Params params;
+                params.character = character;
+
+                std::vector<Vertex<Grid<int>>*> waypoints = graph->vertices();
+                if (waypoints.size() == 0) {
+                    return Accelerations();
+                }
+
+                // Request a path to the next waypoint, following the old path until it resolves
+                if (!this->calculatedPath || (this->ticket == -1 && this->follower.onLastSegment())) {
+                    this->calculatedPath = true;
+                    if (this->ticket != -1) {
+                        engine->cancelPath(this->ticket);
+                    }
+
+                    if (this->current == nullptr) {
+                        // Join the graph at the closest waypoint
+                        float closest = std::numeric_limits<float>::max();
+                        for (Vertex<Grid<int>> *waypoint : waypoints) {
+                            sf::Vector2f position = sf::Vector2f(waypoint->getElement().column * spacing.x, waypoint->getElement().row * spacing.y);
+                            if (Vmath::length(position - character.position) < closest) {
+                                closest = Vmath::length(position - character.position);
+                                this->current = waypoint;
+                            }
+                        }
+                    } else {
+                        // Pick a new destination once the last one is reached (or turns out to be unreachable)
+                        if (this->destination == nullptr || this->destination == this->current || !table->reachable(this->current, this->destination)) {
+                            this->destination = waypoints.at(rand() % waypoints.size());
+                        }
+
+                        // The table gives the first edge of the shortest route, so the waypoint across it is the next one to visit
+                        Edge<int> *hop = table->nextHop(this->current, this->destination);
+                        if (hop != nullptr) {
+                            this->current = graph->opposite(this->current, hop);
+                        }
                     }
+
+                    sf::Vector2f goal = sf::Vector2f(this->current->getElement().column * spacing.x, this->current->getElement().row * spacing.y);
+                    this->ticket = engine->requestPath(character.position, goal, heuristic, engine->pathPriority(character.position), "PathfindAlongWaypointGraph");
                 }
-                this->currentIndex = minIndex;
 
-                params.target.position = engine->getEnvironment()->localizeEndpoint(this->path.at(this->currentIndex), 1);
+                // Switch to the new path once it has resolved
+                if (this->ticket != -1 && engine->pollPath(this->ticket, &this->path)) {
+                    this->ticket = -1;
+                    this->follower.setPath(engine->getEnvironment(), this->path);
+
+                    // A waypoint on the character's own tile is reached without moving, so head for the next one on the following frame
+                    if (this->path.size() == 0) {
+                        this->calculatedPath = false;
+                    }
+                }
+
+                if (this->path.size() == 0) {
+                    return Accelerations();
+                }
+
+                // Head for the end of the path segment the character's future position is on
+                sf::Vector2f futurePosition = character.position + character.linearVelocity * this->predictTime;
+                params.target.position = this->follower.follow(futurePosition);
                 return behavior->find(params);
             };
         }
 
+        // Rejoin the graph at the closest waypoint
         void reset() {
             this->calculatedPath = false;
+            this->current = nullptr;
         }
 };
 
@@ -12,213 +12,87 @@
 #include <algorithm>
 #include <iterator>
 #include <iostream>
+#include <functional>
 #include "../graph/graph.hpp"
 #include "./heuristic.hpp"
-
-// VertexRecord is used to keep track of information associated with each vertex
-template <typename V, typename E>
-struct VertexRecord {
-    Vertex<V> *vertex;
-    Edge<E> *edge;
-    E cost;      // Represents estimatedCost in A*
-    E costSoFar; // Only used in A*
-
-    // Compare VertexRecords by looking at their underlying cost
-    bool operator < (const VertexRecord<V, E> r) const {
-        return this->cost < r.cost;
-    }
-    bool operator > (const VertexRecord<V, E> r) const {
-        return this->cost > r.cost;
-    }
-};
-
-// AdaptableSearchableVector extends vector functionality to find and update path costs
-template <typename V, typename E>
-class AdaptableSearchableVector : public std::vector<VertexRecord<V, E>> {
-    public:
-        // Find a given element (returns the iterator of that element, or the end of the vector if the element cannot be found)
-        typename std::vector<VertexRecord<V, E>>::iterator find(Vertex<V> *item) {
-            for (typename std::vector<VertexRecord<V, E>>::size_type i = 0; i < this->size(); i++) {
-                if (this->at(i).vertex == item) {
-                    return this->begin() + i;
-                }
-            }
-
-            return this->end();
-        }
-};
+#include "./stats.hpp"
+#include "./reservation-table.hpp"
+#include "./graph-search.hpp"
+#include "./hda-star.hpp"
+#include "./delta-stepping.hpp"
 
 // Algorithm class which contains static methods for algorithms
 template <typename V, typename E>
 class Algorithm {
     public:
         // Dijkstra's Algorithm, which finds the shortest path between two vertices in a given graph
-        static bool dijkstras(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex) {
-            // Initialize the open and closed lists
-            AdaptableSearchableVector<V, E> openList;
-            AdaptableSearchableVector<V, E> closedList;
-
-            // Initialize the record for the start node
-            VertexRecord<V, E> start;
-            start.vertex = startVertex;
-            start.cost = 0;
-            openList.push_back(start);
-
-            // Iterate through processing each vertex
-            VertexRecord<V, E> current;
-            while (openList.size() > 0) {
-                // Get the smallest element in the open list
-                std::pop_heap(openList.begin(), openList.end(), std::greater<VertexRecord<V, E>>{});
-                current = openList.back();
-                openList.pop_back();
-
-                // If the current vertex is the end vertex, break
-                if (current.vertex == endVertex) {
-                    break;
-                }
-
-                // Loop through each edge in the vertex
-                for (Edge<E> *e : *graph->outgoingEdges(current.vertex)) {
-                    // Get the cost estimate for each new vertex
-                    Vertex<V> *opposite = graph->opposite(current.vertex, e);
-                    E newCost = current.cost + e->getElement();
-
-                    if (closedList.find(opposite) != closedList.end()) {
-                        // Skip if the vertex is closed
-                        continue;
-                    } else if (openList.find(opposite) != openList.end()) {
-                        // The vertex is open, so check if we've found a better path
-                        VertexRecord<V, E> record = (*openList.find(opposite));
-                        record.cost = std::min<E>(record.cost, newCost);
-                    } else {
-                        // We have an unvisited vertex, so record it
-                        VertexRecord<V, E> record;
-                        record.vertex = opposite;
-                        record.cost = newCost;
-                        record.edge = e;
-
-                        openList.push_back(record);
-                    }
-                }
-                
-                // Move the current vertex to the closed list
-                closedList.push_back(current);
-
-                // Make sure the open list is a heap
-                std::make_heap(openList.begin(), openList.end(), std::greater<VertexRecord<V, E>>{});
-            }
-
-            // Make sure we've reached the goal vertex
-            if (current.vertex != endVertex) {
-                return false;
-            }
-            
-            // Compile a list of edges we took to get to this path
-            while (current.vertex != startVertex) {
-                path->push_back(current.edge);
-                current = (*closedList.find(graph->opposite(current.vertex, current.edge)));
-            }
-
-            // Return the reversed path
-            std::reverse(std::begin(*path), std::end(*path));
-            return true;
+        static bool dijkstras(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, SearchStats *stats = nullptr) {
+            return Search::dijkstras(path, graph, startVertex, endVertex, stats);
         }
 
         // A* algorithm, which uses dijkstra's algorithm plus a heuristic
-        static bool astar(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic) {
-            // Initialize the open and closed lists
-            AdaptableSearchableVector<V, E> openList;
-            AdaptableSearchableVector<V, E> closedList;
-
-            // Initialize the record for the start node
-            VertexRecord<V, E> start;
-            start.vertex = startVertex;
-            start.costSoFar = 0;
-            start.cost = heuristic->estimate(startVertex, endVertex);
-            openList.push_back(start);
-
-            // Iterate through processing each vertex
-            VertexRecord<V, E> current;
-            while (openList.size() > 0) {
-                // Get the smallest element in the open list
-                std::pop_heap(openList.begin(), openList.end(), std::greater<VertexRecord<V, E>>{});
-                current = openList.back();
-                openList.pop_back();
-
-                // If the current vertex is the end vertex, break
-                if (current.vertex == endVertex) {
-                    break;
-                }
-
-                // Loop through each edge in the vertex
-                for (Edge<E> *e : *graph->outgoingEdges(current.vertex)) {
-                    // Get the cost estimate for each new vertex
-                    Vertex<V> *opposite = graph->opposite(current.vertex, e);
-                    E newCost = current.costSoFar + e->getElement();
-
-                    if (closedList.find(opposite) != closedList.end()) {
-                        // Either skip or remove the vertex from the closed list
-                        VertexRecord<V, E> record = (*closedList.find(opposite));
+        static bool astar(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic, SearchStats *stats = nullptr) {
+            return Search::astar(path, graph, startVertex, endVertex, estimator(heuristic), stats);
+        }
 
-                        // If we didn't find a shorter route, skip
-                        if (record.costSoFar <= newCost) {
-                            continue;
-                        }
+        // Weighted A* algorithm, which inflates the heuristic by (1 + epsilon) to expand fewer vertices
+        // With a consistent heuristic the path cost is at most (1 + epsilon) times the optimal cost, without reopening closed vertices
+        static bool weightedAstar(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic, float epsilon, SearchStats *stats = nullptr) {
+            return Search::weightedAstar(path, graph, startVertex, endVertex, estimator(heuristic), epsilon, stats);
+        }
 
-                        // Otherwise, remove it from the closed list and add it back to the open list
-                        closedList.erase(closedList.find(opposite));
+        // Focal A* (A*epsilon), which expands the open vertex closest to the goal out of every vertex whose estimated cost is within (1 + epsilon) of the best
+        // With an admissible heuristic the path cost is at most (1 + epsilon) times the optimal cost
+        static bool focalAstar(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic, float epsilon, SearchStats *stats = nullptr) {
+            return Search::focalAstar(path, graph, startVertex, endVertex, estimator(heuristic), epsilon, stats);
+        }
 
-                        record.cost = newCost + (record.cost - record.costSoFar);
-                        record.costSoFar = newCost;
-                        record.edge = e;
-                    } else if (openList.find(opposite) != openList.end()) {
-                        // The vertex is open, so check if we've found a better path
-                        VertexRecord<V, E> record = (*openList.find(opposite));
+        // Multi-goal search, which runs a single Dijkstra's (or A* if a heuristic is given) search that stops at the first goal reached
+        static bool nearestGoal(std::vector<Edge<E>*> *path, int *reachedGoal, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, std::vector<Vertex<V>*> goals, Heuristic<V, E> *heuristic = nullptr, SearchStats *stats = nullptr) {
+            return Search::nearestGoal(path, reachedGoal, graph, startVertex, goals, estimator(heuristic), stats);
+        }
 
-                        // Continue if we didn't find a better path
-                        if (record.costSoFar <= newCost) {
-                            continue;
-                        }
+        // Bidirectional Dijkstra's algorithm, which searches forward from the start and backward from the end until the searches meet
+        static bool bidirectionalDijkstra(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, SearchStats *stats = nullptr) {
+            return Search::bidirectionalDijkstra(path, graph, startVertex, endVertex, stats);
+        }
 
-                        // Update the costs and heuristic
-                        record.cost = newCost + (record.cost - record.costSoFar);
-                        record.costSoFar = newCost;
-                        record.edge = e;
-                    } else {
-                        // We have an unvisited vertex, so record it
-                        VertexRecord<V, E> record;
+        // Bidirectional A* algorithm, which guides both searches with the average of the forward and backward heuristics
+        // The heuristic should be consistent and symmetric (estimate(a, b) == estimate(b, a)), like the grid heuristics
+        static bool bidirectionalAstar(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic, SearchStats *stats = nullptr) {
+            return Search::bidirectionalAstar(path, graph, startVertex, endVertex, estimator(heuristic), stats);
+        }
 
-                        record.vertex = opposite;
-                        record.edge = e;
-                        record.costSoFar = newCost;
-                        record.cost = newCost + heuristic->estimate(opposite, endVertex);
+        // Hash distributed A* (HDA*), which splits a single query across a number of threads (0 uses every hardware thread)
+        // The heuristic is called from every thread, so it must not keep any state between estimates (the open list peak in the stats is the sum of the threads' peaks)
+        static bool parallelAstar(std::vector<Edge<E>*> *path, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic, unsigned int threads = 0, SearchStats *stats = nullptr) {
+            HashDistributedAstar<V, E> search(graph, startVertex, endVertex, heuristic, threads);
+            return search.search(path, stats);
+        }
 
-                        openList.push_back(record);
-                    }
-                }
-                
-                // Move the current vertex to the closed list
-                closedList.push_back(current);
+        // Parallel delta-stepping, which finds the distance from a source vertex to every vertex id of a flat graph
+        // Unreachable vertices get the maximum distance and a predecessor of -1 (delta is the bucket width, which trades parallelism against wasted relaxations)
+        // Throws std::invalid_argument if delta isn't positive
+        static void deltaStepping(FlatGraph<V, E> *graph, Vertex<V> *sourceVertex, E delta, std::vector<E> *distance, std::vector<int> *predecessor, unsigned int threads = 0, SearchStats *stats = nullptr) {
+            DeltaStepping<V, E> search(graph, delta, threads);
+            search.solve(graph->id(sourceVertex), distance, predecessor, stats);
+        }
 
-                // Make sure the open list is a heap
-                std::make_heap(openList.begin(), openList.end(), std::greater<VertexRecord<V, E>>{});
-            }
+        // Windowed cooperative A* (WHCA*), which searches space-time around other agents' reservations for a given window of timesteps
+        // The timed path holds the vertex the agent should be on at each timestep (waits repeat a vertex)
+        static bool cooperativeAstar(std::vector<Vertex<V>*> *timedPath, AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic, ReservationTable<Vertex<V>*> *table, int agent, int startTime, int window, SearchStats *stats = nullptr) {
+            return Search::cooperativeAstar(timedPath, graph, startVertex, endVertex, estimator(heuristic), table, agent, startTime, window, stats);
+        }
 
-            // Make sure we've reached the goal vertex
-            if (current.vertex != endVertex) {
-                return false;
-            }
-            
-            // Compile a list of edges we took to get to this path
-            while (current.vertex != startVertex) {
-                path->push_back(current.edge);
-                current = (*closedList.find(graph->opposite(current.vertex, current.edge)));
-            }
+    private:
+        typedef GraphSearch<AdjacencyListGraph<V, E>> Search;
 
-            // Return the reversed path
-            std::reverse(std::begin(*path), std::end(*path));
-            return true;
+        // Wrap a heuristic in a callable for GraphSearch (a missing heuristic estimates 0 everywhere)
+        static auto estimator(Heuristic<V, E> *heuristic) {
+            return [heuristic](Vertex<V> *from, Vertex<V> *to) -> E {
+                return heuristic == nullptr ? 0 : heuristic->estimate(from, to);
+            };
         }
 };
 
-#endif
\ No newline at end of file
+#endif
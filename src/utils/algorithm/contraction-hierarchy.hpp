@@ -0,0 +1,620 @@
+/**
+ * ContractionHierarchy answers point-to-point shortest path queries on large static graphs
+ *
+ * Vertices are contracted from least to most important, adding shortcut edges wherever a shortest
+ * path ran through the contracted vertex. Queries then run a bidirectional Dijkstra search that only
+ * ever moves up the hierarchy, and shortcuts are unpacked back into the graph's edges.
+ *
+ * Adapted from "Contraction Hierarchies: Faster and Simpler Hierarchical Routing in Road Networks"
+ * by Geisberger, Sanders, Schultes and Delling. Independent sets of vertices are contracted in parallel.
+ */
+#ifndef CONTRACTION_HIERARCHY
+#define CONTRACTION_HIERARCHY
+
+#include <queue>
+#include <vector>
+#include <map>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include "../graph/graph.hpp"
+#include "./stats.hpp"
+
+// ContractionHierarchy holds the vertex order and shortcuts of a contracted graph
+template <typename V, typename E>
+class ContractionHierarchy {
+    private:
+        // Arc is either an edge of the graph or a shortcut made of two other arcs
+        struct Arc {
+            int from;
+            int to;
+            E weight;
+            int edge;   // Index into the graph's edge list (-1 for shortcuts)
+            int first;  // Arcs the shortcut replaces (-1 for edges)
+            int second;
+        };
+
+        // WitnessSpace is the per-thread scratch space for witness searches
+        struct WitnessSpace {
+            std::vector<E> distance;
+            std::vector<int> reached; // Search number the distance was set in
+            int search = 0;
+        };
+
+        AdjacencyListGraph<V, E> *graph;
+        std::vector<Vertex<V>*> vertexList;
+        std::vector<Edge<E>*> edgeList;
+        std::map<Vertex<V>*, int> vertexIndex;
+        int n = 0;
+
+        std::vector<Arc> arcs;
+        std::vector<int> rank; // Contraction order of each vertex (-1 while uncontracted)
+
+        // Arcs used by queries: upward arcs leave a vertex, downward arcs enter a vertex from a higher one
+        std::vector<std::vector<int>> up;
+        std::vector<std::vector<int>> down;
+
+        // Query scratch space (so queries do not allocate per call)
+        std::vector<E> forwardDistance;
+        std::vector<E> backwardDistance;
+        std::vector<int> forwardParent;
+        std::vector<int> backwardParent;
+        std::vector<int> forwardReached;
+        std::vector<int> backwardReached;
+        int query = 0;
+
+        // Witness searches give up after settling this many vertices (and add the shortcut to stay correct)
+        int witnessLimit = 500;
+
+        // Add the graph's edges as the initial arcs
+        void initArcs() {
+            std::map<Edge<E>*, int> edgeIndex;
+            for (typename std::vector<Edge<E>*>::size_type i = 0; i < this->edgeList.size(); i++) {
+                edgeIndex[this->edgeList.at(i)] = i;
+            }
+
+            this->arcs.clear();
+            for (int i = 0; i < this->n; i++) {
+                for (Edge<E> *e : *this->graph->outgoingEdges(this->vertexList.at(i))) {
+                    Arc arc;
+                    arc.from = i;
+                    arc.to = this->vertexIndex[this->graph->opposite(this->vertexList.at(i), e)];
+                    arc.weight = e->getElement();
+                    arc.edge = edgeIndex[e];
+                    arc.first = -1;
+                    arc.second = -1;
+
+                    if (arc.from != arc.to) {
+                        this->arcs.push_back(arc);
+                    }
+                }
+            }
+        }
+
+        // Run a function over [0, count) across a number of threads, passing each call its thread number
+        static void parallelFor(int count, unsigned int threads, std::function<void(int, int)> fn) {
+            std::atomic<int> next(0);
+            std::function<void(int)> worker = [&next, count, &fn](int thread) {
+                for (int i = next++; i < count; i = next++) {
+                    fn(i, thread);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned int t = 1; t < threads && (int) t < count; t++) {
+                workers.push_back(std::thread(worker, t));
+            }
+            worker(0);
+
+            for (std::thread &t : workers) {
+                t.join();
+            }
+        }
+
+        // Find the shortcuts contracting a vertex would need, given the vertices contracted so far
+        std::vector<Arc> shortcutsFor(int v, std::vector<std::vector<int>> &outArcs, std::vector<std::vector<int>> &inArcs, WitnessSpace *space) {
+            // Keep only the cheapest shortcut between each pair of neighbours
+            std::map<std::pair<int, int>, Arc> shortcuts;
+
+            for (int a : inArcs.at(v)) {
+                int u = this->arcs.at(a).from;
+                if (this->rank.at(u) != -1) {
+                    continue;
+                }
+
+                // The witness search only needs to look as far as the longest path through v
+                E maxCost = E();
+                bool anyTarget = false;
+                for (int b : outArcs.at(v)) {
+                    int x = this->arcs.at(b).to;
+                    if (this->rank.at(x) == -1 && x != u) {
+                        E cost = this->arcs.at(a).weight + this->arcs.at(b).weight;
+                        maxCost = !anyTarget || maxCost < cost ? cost : maxCost;
+                        anyTarget = true;
+                    }
+                }
+                if (!anyTarget) {
+                    continue;
+                }
+
+                // Dijkstra's algorithm from u, avoiding v and contracted vertices
+                space->search++;
+                std::priority_queue<std::pair<E, int>, std::vector<std::pair<E, int>>, std::greater<std::pair<E, int>>> open;
+                space->distance.at(u) = E();
+                space->reached.at(u) = space->search;
+                open.push(std::make_pair(E(), u));
+
+                int settled = 0;
+                while (!open.empty() && settled < this->witnessLimit) {
+                    std::pair<E, int> current = open.top();
+                    open.pop();
+
+                    if (current.first > space->distance.at(current.second)) {
+                        continue;
+                    }
+                    if (maxCost < current.first) {
+                        break;
+                    }
+                    settled++;
+
+                    for (int c : outArcs.at(current.second)) {
+                        int w = this->arcs.at(c).to;
+                        if (w == v || this->rank.at(w) != -1) {
+                            continue;
+                        }
+
+                        E cost = current.first + this->arcs.at(c).weight;
+                        if (space->reached.at(w) != space->search || cost < space->distance.at(w)) {
+                            space->distance.at(w) = cost;
+                            space->reached.at(w) = space->search;
+                            open.push(std::make_pair(cost, w));
+                        }
+                    }
+                }
+
+                // Any neighbour without a witness path at least as short needs a shortcut
+                for (int b : outArcs.at(v)) {
+                    int x = this->arcs.at(b).to;
+                    if (this->rank.at(x) != -1 || x == u) {
+                        continue;
+                    }
+
+                    E cost = this->arcs.at(a).weight + this->arcs.at(b).weight;
+                    if (space->reached.at(x) == space->search && !(cost < space->distance.at(x))) {
+                        continue;
+                    }
+
+                    std::pair<int, int> key = std::make_pair(u, x);
+                    if (shortcuts.find(key) == shortcuts.end() || cost < shortcuts[key].weight) {
+                        Arc shortcut;
+                        shortcut.from = u;
+                        shortcut.to = x;
+                        shortcut.weight = cost;
+                        shortcut.edge = -1;
+                        shortcut.first = a;
+                        shortcut.second = b;
+                        shortcuts[key] = shortcut;
+                    }
+                }
+            }
+
+            std::vector<Arc> result;
+            for (typename std::map<std::pair<int, int>, Arc>::iterator it = shortcuts.begin(); it != shortcuts.end(); it++) {
+                result.push_back(it->second);
+            }
+            return result;
+        }
+
+        // Rebuild the upward and downward query arcs from the vertex ranks
+        void buildSearchGraph() {
+            this->up = std::vector<std::vector<int>>(this->n);
+            this->down = std::vector<std::vector<int>>(this->n);
+
+            for (typename std::vector<Arc>::size_type i = 0; i < this->arcs.size(); i++) {
+                Arc &arc = this->arcs.at(i);
+                if (this->rank.at(arc.from) < this->rank.at(arc.to)) {
+                    this->up.at(arc.from).push_back(i);
+                } else {
+                    this->down.at(arc.to).push_back(i);
+                }
+            }
+
+            this->forwardDistance = std::vector<E>(this->n, E());
+            this->backwardDistance = std::vector<E>(this->n, E());
+            this->forwardParent = std::vector<int>(this->n, -1);
+            this->backwardParent = std::vector<int>(this->n, -1);
+            this->forwardReached = std::vector<int>(this->n, 0);
+            this->backwardReached = std::vector<int>(this->n, 0);
+            this->query = 0;
+        }
+
+        // Unpack an arc into the graph edges it stands for
+        void unpack(int arc, std::vector<Edge<E>*> *path) {
+            std::vector<int> stack;
+            stack.push_back(arc);
+
+            while (stack.size() > 0) {
+                Arc &current = this->arcs.at(stack.back());
+                stack.pop_back();
+
+                if (current.edge != -1) {
+                    path->push_back(this->edgeList.at(current.edge));
+                } else {
+                    stack.push_back(current.second);
+                    stack.push_back(current.first);
+                }
+            }
+        }
+
+    public:
+        // Constructor for a contraction hierarchy over a graph (the hierarchy is empty until it is built or loaded)
+        ContractionHierarchy(AdjacencyListGraph<V, E> *graph) {
+            this->graph = graph;
+            this->vertexList = graph->vertices();
+            this->edgeList = graph->edges();
+            this->n = this->vertexList.size();
+
+            for (int i = 0; i < this->n; i++) {
+                this->vertexIndex[this->vertexList.at(i)] = i;
+            }
+        }
+
+        // Contract the graph, running witness searches across a number of threads (0 uses every hardware thread)
+        void build(unsigned int threads = 0) {
+            if (threads == 0) {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            this->initArcs();
+            this->rank = std::vector<int>(this->n, -1);
+
+            std::vector<std::vector<int>> outArcs(this->n);
+            std::vector<std::vector<int>> inArcs(this->n);
+            for (typename std::vector<Arc>::size_type i = 0; i < this->arcs.size(); i++) {
+                outArcs.at(this->arcs.at(i).from).push_back(i);
+                inArcs.at(this->arcs.at(i).to).push_back(i);
+            }
+
+            std::vector<WitnessSpace> spaces(threads);
+            for (WitnessSpace &space : spaces) {
+                space.distance = std::vector<E>(this->n, E());
+                space.reached = std::vector<int>(this->n, 0);
+            }
+
+            // Priority weighs the edge difference against the number of contracted neighbours and the depth of the hierarchy (lower is contracted first)
+            std::vector<int> contractedNeighbours(this->n, 0);
+            std::vector<int> level(this->n, 0);
+            std::vector<int> priority(this->n, 0);
+            std::function<void(std::vector<int>&)> updatePriorities = [&](std::vector<int> &vertices) {
+                parallelFor(vertices.size(), threads, [&](int i, int thread) {
+                    int v = vertices.at(i);
+
+                    int degree = 0;
+                    for (int a : inArcs.at(v)) {
+                        degree += this->rank.at(this->arcs.at(a).from) == -1;
+                    }
+                    for (int a : outArcs.at(v)) {
+                        degree += this->rank.at(this->arcs.at(a).to) == -1;
+                    }
+
+                    int shortcuts = this->shortcutsFor(v, outArcs, inArcs, &spaces.at(thread)).size();
+                    priority.at(v) = 2 * (shortcuts - degree) + contractedNeighbours.at(v) + level.at(v);
+                });
+            };
+
+            std::vector<int> remaining;
+            for (int i = 0; i < this->n; i++) {
+                remaining.push_back(i);
+            }
+            updatePriorities(remaining);
+
+            int nextRank = 0;
+            while (remaining.size() > 0) {
+                // Pick every vertex that is less important than all of its uncontracted neighbours
+                std::vector<int> selected;
+                for (int v : remaining) {
+                    bool minimal = true;
+                    for (int pass = 0; pass < 2 && minimal; pass++) {
+                        for (int a : pass == 0 ? inArcs.at(v) : outArcs.at(v)) {
+                            int w = pass == 0 ? this->arcs.at(a).from : this->arcs.at(a).to;
+                            if (this->rank.at(w) == -1 && w != v && (priority.at(w) < priority.at(v) || (priority.at(w) == priority.at(v) && w < v))) {
+                                minimal = false;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (minimal) {
+                        selected.push_back(v);
+                    }
+                }
+
+                // Selected vertices are independent, so their shortcuts can be found in parallel
+                // They are marked as contracted first so no witness path runs through a vertex contracted alongside it
+                for (int v : selected) {
+                    this->rank.at(v) = -2;
+                }
+
+                std::vector<std::vector<Arc>> shortcuts(selected.size());
+                parallelFor(selected.size(), threads, [&](int i, int thread) {
+                    shortcuts.at(i) = this->shortcutsFor(selected.at(i), outArcs, inArcs, &spaces.at(thread));
+                });
+
+                // Contract the selected vertices and add their shortcuts
+                std::vector<int> touched;
+                for (typename std::vector<int>::size_type i = 0; i < selected.size(); i++) {
+                    int v = selected.at(i);
+                    this->rank.at(v) = nextRank++;
+
+                    for (Arc &shortcut : shortcuts.at(i)) {
+                        outArcs.at(shortcut.from).push_back(this->arcs.size());
+                        inArcs.at(shortcut.to).push_back(this->arcs.size());
+                        this->arcs.push_back(shortcut);
+                    }
+
+                    for (int pass = 0; pass < 2; pass++) {
+                        for (int a : pass == 0 ? inArcs.at(v) : outArcs.at(v)) {
+                            int w = pass == 0 ? this->arcs.at(a).from : this->arcs.at(a).to;
+                            if (this->rank.at(w) == -1) {
+                                contractedNeighbours.at(w)++;
+                                level.at(w) = std::max(level.at(w), level.at(v) + 1);
+                                touched.push_back(w);
+                            }
+                        }
+                    }
+                }
+
+                // Only the neighbours of contracted vertices can change priority
+                std::sort(touched.begin(), touched.end());
+                touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+                touched.erase(std::remove_if(touched.begin(), touched.end(), [this](int w) { return this->rank.at(w) != -1; }), touched.end());
+                updatePriorities(touched);
+
+                remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [this](int v) { return this->rank.at(v) != -1; }), remaining.end());
+            }
+
+            this->buildSearchGraph();
+        }
+
+        // Return true if the hierarchy has been built or loaded
+        bool isBuilt() {
+            return this->up.size() == (std::size_t) this->n && this->n > 0;
+        }
+
+        // Return the number of shortcuts the hierarchy added
+        int numShortcuts() {
+            int shortcuts = 0;
+            for (Arc &arc : this->arcs) {
+                shortcuts += arc.edge == -1;
+            }
+            return shortcuts;
+        }
+
+        // Find the shortest path between two vertices (returns false if there is no path)
+        // Queries share scratch space, so a hierarchy should only be queried from one thread at a time
+        bool path(std::vector<Edge<E>*> *path, Vertex<V> *startVertex, Vertex<V> *endVertex, SearchStats *stats = nullptr) {
+            SEARCH_STATS(SearchTimer timer(stats);)
+            path->clear();
+
+            int start = this->vertexIndex.at(startVertex);
+            int end = this->vertexIndex.at(endVertex);
+            if (start == end) {
+                return true;
+            }
+
+            this->query++;
+            typedef std::priority_queue<std::pair<E, int>, std::vector<std::pair<E, int>>, std::greater<std::pair<E, int>>> Queue;
+            Queue forward;
+            Queue backward;
+
+            this->forwardDistance.at(start) = E();
+            this->forwardParent.at(start) = -1;
+            this->forwardReached.at(start) = this->query;
+            forward.push(std::make_pair(E(), start));
+
+            this->backwardDistance.at(end) = E();
+            this->backwardParent.at(end) = -1;
+            this->backwardReached.at(end) = this->query;
+            backward.push(std::make_pair(E(), end));
+
+            int meeting = -1;
+            E best = E();
+
+            // Alternate directions until neither can improve on the best meeting point
+            bool forwardTurn = true;
+            while (!forward.empty() || !backward.empty()) {
+                if (forward.empty() || (meeting != -1 && !(forward.top().first < best))) {
+                    forward = Queue();
+                }
+                if (backward.empty() || (meeting != -1 && !(backward.top().first < best))) {
+                    backward = Queue();
+                }
+                if (forward.empty() && backward.empty()) {
+                    break;
+                }
+                if (forward.empty() || backward.empty()) {
+                    forwardTurn = !forward.empty();
+                }
+
+                bool isForward = forwardTurn;
+                forwardTurn = !forwardTurn;
+
+                Queue &open = isForward ? forward : backward;
+                std::vector<E> &distance = isForward ? this->forwardDistance : this->backwardDistance;
+                std::vector<int> &parent = isForward ? this->forwardParent : this->backwardParent;
+                std::vector<int> &reached = isForward ? this->forwardReached : this->backwardReached;
+                std::vector<E> &otherDistance = isForward ? this->backwardDistance : this->forwardDistance;
+                std::vector<int> &otherReached = isForward ? this->backwardReached : this->forwardReached;
+
+                std::pair<E, int> current = open.top();
+                open.pop();
+                int v = current.second;
+
+                if (current.first > distance.at(v)) {
+                    continue;
+                }
+                SEARCH_STATS(if (stats != nullptr) { stats->nodesExpanded++; })
+
+                // Check if the searches meet here
+                if (otherReached.at(v) == this->query) {
+                    E cost = current.first + otherDistance.at(v);
+                    if (meeting == -1 || cost < best) {
+                        meeting = v;
+                        best = cost;
+                    }
+                }
+
+                // Stall vertices that a higher vertex reaches more cheaply (they cannot be on a shortest path)
+                bool stalled = false;
+                for (int a : isForward ? this->down.at(v) : this->up.at(v)) {
+                    int w = isForward ? this->arcs.at(a).from : this->arcs.at(a).to;
+                    if (reached.at(w) == this->query && distance.at(w) + this->arcs.at(a).weight < current.first) {
+                        stalled = true;
+                        break;
+                    }
+                }
+                if (stalled) {
+                    continue;
+                }
+
+                // Relax the arcs leading up the hierarchy (forward follows arcs, backward follows them in reverse)
+                for (int a : isForward ? this->up.at(v) : this->down.at(v)) {
+                    int w = isForward ? this->arcs.at(a).to : this->arcs.at(a).from;
+                    E cost = current.first + this->arcs.at(a).weight;
+
+                    if (reached.at(w) != this->query || cost < distance.at(w)) {
+                        distance.at(w) = cost;
+                        parent.at(w) = a;
+                        reached.at(w) = this->query;
+                        open.push(std::make_pair(cost, w));
+                        SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; })
+                    }
+                }
+                SEARCH_STATS(if (stats != nullptr) { stats->recordOpenList(forward.size() + backward.size()); })
+            }
+
+            if (meeting == -1) {
+                return false;
+            }
+
+            // Collect the arcs from the start to the meeting point, then from the meeting point to the end
+            std::vector<int> forwardArcs;
+            for (int v = meeting; this->forwardParent.at(v) != -1; v = this->arcs.at(this->forwardParent.at(v)).from) {
+                forwardArcs.push_back(this->forwardParent.at(v));
+            }
+            std::reverse(forwardArcs.begin(), forwardArcs.end());
+
+            for (int a : forwardArcs) {
+                this->unpack(a, path);
+            }
+            for (int v = meeting; this->backwardParent.at(v) != -1; v = this->arcs.at(this->backwardParent.at(v)).to) {
+                this->unpack(this->backwardParent.at(v), path);
+            }
+
+            SEARCH_STATS(if (stats != nullptr) { stats->pathLength += path->size(); })
+            return true;
+        }
+
+        // Save the hierarchy to a file
+        bool save(std::string filename) {
+            std::ofstream file(filename);
+            if (!file.is_open() || !this->isBuilt()) {
+                return false;
+            }
+
+            file << "ch," << this->n << "," << this->edgeList.size() << "," << fingerprintGraph(this->graph) << "," << this->arcs.size() << "\n";
+            for (int i = 0; i < this->n; i++) {
+                file << this->rank.at(i) << (i + 1 == this->n ? "\n" : ",");
+            }
+            for (Arc &arc : this->arcs) {
+                file << arc.from << "," << arc.to << "," << arc.weight << "," << arc.edge << "," << arc.first << "," << arc.second << "\n";
+            }
+
+            return true;
+        }
+
+        // Load a hierarchy from a file (returns false if it is missing, corrupt or was built for a different graph)
+        bool load(std::string filename) {
+            std::ifstream file(filename);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            // Check the header matches this graph
+            std::string header;
+            std::getline(file, header);
+
+            std::ostringstream expected;
+            expected << "ch," << this->n << "," << this->edgeList.size() << "," << fingerprintGraph(this->graph) << ",";
+            if (header.compare(0, expected.str().size(), expected.str()) != 0) {
+                return false;
+            }
+            int count;
+            if (!parseField(header.substr(expected.str().size()), &count) || count < 0) {
+                return false;
+            }
+
+            std::string buf;
+            std::vector<int> rank(this->n, -1);
+            for (int i = 0; i < this->n; i++) {
+                if (!std::getline(file, buf, i + 1 == this->n ? '\n' : ',')) {
+                    return false;
+                }
+                if (!parseField(buf, &rank.at(i))) {
+                    return false;
+                }
+            }
+
+            // Ranks must order every vertex exactly once, or queries could miss the meeting point
+            std::vector<bool> ranked(this->n, false);
+            for (int r : rank) {
+                if (r < 0 || r >= this->n || ranked.at(r)) {
+                    return false;
+                }
+                ranked.at(r) = true;
+            }
+
+            std::vector<Arc> arcs;
+            std::string line;
+            for (int i = 0; i < count; i++) {
+                if (!std::getline(file, line)) {
+                    return false;
+                }
+
+                Arc arc;
+                char comma;
+                std::istringstream stream(line);
+                stream >> arc.from >> comma >> arc.to >> comma >> arc.weight >> comma >> arc.edge >> comma >> arc.first >> comma >> arc.second;
+
+                bool valid = stream && (stream >> std::ws).eof() && arc.from >= 0 && arc.from < this->n && arc.to >= 0 && arc.to < this->n;
+                valid = valid && arc.edge < (int) this->edgeList.size() && arc.first < i && arc.second < i;
+                valid = valid && (arc.edge != -1 || (arc.first >= 0 && arc.second >= 0));
+                if (!valid) {
+                    return false;
+                }
+                arcs.push_back(arc);
+            }
+
+            this->rank = rank;
+            this->arcs = arcs;
+            this->buildSearchGraph();
+            return true;
+        }
+};
+
+// Load the contraction hierarchy saved next to a graph's asset, building and saving it if it is missing or stale
+template <typename V, typename E>
+void loadOrBuildContractionHierarchy(ContractionHierarchy<V, E> *hierarchy, std::string assetFilename) {
+    std::string hierarchyFilename = assetFilename + ".ch";
+
+    if (!hierarchy->load(hierarchyFilename)) {
+        hierarchy->build();
+        hierarchy->save(hierarchyFilename);
+    }
+}
+
+#endif
@@ -0,0 +1,288 @@
+/**
+ * DeltaStepping finds the shortest distance from one vertex to every other vertex using several threads
+ *
+ * Tentative distances are sorted into buckets of width delta. Each bucket is settled in rounds: light arcs
+ * (cost <= delta) are relaxed in parallel until the bucket stops refilling, then heavy arcs are relaxed once.
+ * Every vertex is owned by one thread, which keeps its own bucket lists. Every round each thread takes its
+ * vertices out of the current bucket, generates relaxation requests from their arcs, and then applies the
+ * requests for the vertices it owns, so no two threads ever write the same vertex or bucket list.
+ *
+ * Adapted from "Delta-stepping: a parallelizable shortest path algorithm" by Meyer and Sanders
+ */
+#ifndef DELTA_STEPPING
+#define DELTA_STEPPING
+
+#include <vector>
+#include <mutex>
+#include <limits>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <condition_variable>
+#include "../graph/flat-graph.hpp"
+#include "./stats.hpp"
+
+// StepBarrier blocks threads until every one of them has reached it
+class StepBarrier {
+    private:
+        std::mutex lock;
+        std::condition_variable condition;
+        unsigned int threads;
+        unsigned int waiting = 0;
+        unsigned int generation = 0;
+
+    public:
+        StepBarrier(unsigned int threads) {
+            this->threads = threads;
+        }
+
+        // Wait for every other thread to arrive
+        void wait() {
+            std::unique_lock<std::mutex> guard(this->lock);
+            unsigned int arrivedIn = this->generation;
+
+            if (++this->waiting == this->threads) {
+                this->waiting = 0;
+                this->generation++;
+                this->condition.notify_all();
+                return;
+            }
+
+            this->condition.wait(guard, [this, arrivedIn] { return this->generation != arrivedIn; });
+        }
+};
+
+// DeltaStepping holds the shared state of one single-source shortest path computation
+template <typename V, typename E>
+class DeltaStepping {
+    private:
+        // Request asks the owner of a vertex to lower its distance
+        struct Request {
+            int target;
+            int predecessor;
+            E distance;
+        };
+
+        FlatGraph<V, E> *graph;
+        E delta;
+        unsigned int threads;
+
+        std::vector<E> *distance;
+        std::vector<int> *predecessor;
+
+        // Shared round state (only changed by thread 0 between rounds)
+        std::size_t bucket = 0;
+        bool heavy = false;    // True while the current round relaxes heavy arcs
+        bool relaxing = false; // True if the current round has any vertices to relax
+        bool finished = false;
+        int round = 0;
+
+        // State kept by each owner thread
+        std::vector<std::vector<std::vector<int>>> buckets; // Bucket lists of the vertices each thread owns
+        std::vector<std::vector<int>> work;                 // Vertices whose arcs each thread relaxes this round
+        std::vector<std::vector<int>> settled;              // Vertices each thread removed from the current bucket (their heavy arcs are relaxed last)
+        std::vector<int> workStamp;
+        std::vector<int> settledStamp;
+        std::vector<char> heavyArcs;                        // True if a thread skipped heavy arcs in the current bucket
+        std::vector<SearchStats> ownerStats;
+
+        std::vector<std::vector<std::vector<Request>>> requests; // Requests from each thread to each owner
+
+        SearchStats roundStats;
+
+        // Get the bucket a distance belongs in
+        std::size_t bucketOf(E distance) {
+            return (std::size_t) (distance / this->delta);
+        }
+
+        // Take a thread's vertices out of the current bucket (a vertex may have been added more than once)
+        void collect(unsigned int id) {
+            this->work.at(id).clear();
+            if (this->heavy || this->bucket >= this->buckets.at(id).size()) {
+                return;
+            }
+
+            for (int v : this->buckets.at(id).at(this->bucket)) {
+                if (this->workStamp.at(v) != this->round && this->bucketOf(this->distance->at(v)) == this->bucket) {
+                    this->workStamp.at(v) = this->round;
+                    this->work.at(id).push_back(v);
+
+                    if (this->settledStamp.at(v) != (int) this->bucket) {
+                        this->settledStamp.at(v) = this->bucket;
+                        this->settled.at(id).push_back(v);
+                    }
+                }
+            }
+            this->buckets.at(id).at(this->bucket).clear();
+        }
+
+        // Move on to the next bucket any thread still has vertices in (finishing once there are none)
+        void nextBucket() {
+            for (std::vector<int> &vertices : this->settled) {
+                vertices.clear();
+            }
+            std::fill(this->heavyArcs.begin(), this->heavyArcs.end(), false);
+
+            std::size_t end = 0;
+            for (std::vector<std::vector<int>> &owned : this->buckets) {
+                end = std::max(end, owned.size());
+            }
+
+            this->bucket++;
+            while (this->bucket < end) {
+                for (std::vector<std::vector<int>> &owned : this->buckets) {
+                    if (this->bucket < owned.size() && owned.at(this->bucket).size() > 0) {
+                        return;
+                    }
+                }
+                this->bucket++;
+            }
+            this->finished = true;
+        }
+
+        // Decide what the next round does from what every thread collected (run by a single thread between rounds)
+        void nextRound() {
+            this->round++;
+
+            // After the heavy arcs the bucket is done
+            if (this->heavy) {
+                this->heavy = false;
+                this->relaxing = false;
+                this->nextBucket();
+                return;
+            }
+
+            std::size_t collected = 0;
+            bool heavyLeft = false;
+            for (unsigned int t = 0; t < this->threads; t++) {
+                collected += this->work.at(t).size();
+                heavyLeft = heavyLeft || this->heavyArcs.at(t);
+            }
+            SEARCH_STATS(this->roundStats.nodesExpanded += collected;)
+
+            // Once the bucket stops refilling, relax the heavy arcs of everything it held (if it skipped any)
+            this->relaxing = collected > 0 || heavyLeft;
+            if (collected == 0 && heavyLeft) {
+                this->heavy = true;
+            } else if (collected == 0) {
+                this->nextBucket();
+            }
+        }
+
+        // Run one thread until every bucket is empty
+        void run(unsigned int id, StepBarrier *barrier) {
+            while (true) {
+                this->collect(id);
+                barrier->wait();
+
+                if (id == 0) {
+                    this->nextRound();
+                }
+                barrier->wait();
+
+                if (this->finished) {
+                    return;
+                }
+                if (!this->relaxing) {
+                    continue;
+                }
+
+                // Generate requests from the arcs of this thread's vertices
+                for (int v : this->heavy ? this->settled.at(id) : this->work.at(id)) {
+                    E base = this->distance->at(v);
+
+                    for (int arc = this->graph->arcsBegin(v); arc < this->graph->arcsEnd(v); arc++) {
+                        E weight = this->graph->weight(arc);
+                        if ((weight <= this->delta) == this->heavy) {
+                            this->heavyArcs.at(id) = this->heavyArcs.at(id) || !this->heavy;
+                            continue;
+                        }
+
+                        Request request;
+                        request.target = this->graph->target(arc);
+                        request.predecessor = v;
+                        request.distance = base + weight;
+                        this->requests.at(id).at(request.target % this->threads).push_back(request);
+                    }
+                }
+                barrier->wait();
+
+                // Apply the requests for the vertices this thread owns, moving the improved ones into its buckets
+                std::vector<std::vector<int>> &owned = this->buckets.at(id);
+                for (unsigned int from = 0; from < this->threads; from++) {
+                    for (Request &request : this->requests.at(from).at(id)) {
+                        if (request.distance < this->distance->at(request.target)) {
+                            this->distance->at(request.target) = request.distance;
+                            this->predecessor->at(request.target) = request.predecessor;
+
+                            std::size_t target = this->bucketOf(request.distance);
+                            if (target >= owned.size()) {
+                                owned.resize(target + 1);
+                            }
+                            owned.at(target).push_back(request.target);
+                            SEARCH_STATS(this->ownerStats.at(id).nodesGenerated++;)
+                        }
+                    }
+                    this->requests.at(from).at(id).clear();
+                }
+            }
+        }
+
+    public:
+        // Setup a computation over a flat graph with a bucket width and number of threads (0 uses every hardware thread)
+        DeltaStepping(FlatGraph<V, E> *graph, E delta, unsigned int threads = 0) {
+            // Buckets are delta wide, so a delta of zero or less can't sort distances into them
+            if (!(delta > E())) {
+                throw std::invalid_argument("Delta is not positive");
+            }
+
+            this->graph = graph;
+            this->delta = delta;
+            this->threads = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+        }
+
+        // Find the distance to and predecessor of every vertex id (unreachable vertices get the maximum distance and predecessor -1)
+        void solve(int source, std::vector<E> *distance, std::vector<int> *predecessor, SearchStats *stats = nullptr) {
+            SEARCH_STATS(SearchTimer timer(stats);)
+
+            int n = this->graph->numVertices();
+            *distance = std::vector<E>(n, std::numeric_limits<E>::max());
+            *predecessor = std::vector<int>(n, -1);
+            this->distance = distance;
+            this->predecessor = predecessor;
+
+            this->workStamp = std::vector<int>(n, -1);
+            this->settledStamp = std::vector<int>(n, -1);
+            this->requests = std::vector<std::vector<std::vector<Request>>>(this->threads, std::vector<std::vector<Request>>(this->threads));
+            this->buckets = std::vector<std::vector<std::vector<int>>>(this->threads);
+            this->work = std::vector<std::vector<int>>(this->threads);
+            this->settled = std::vector<std::vector<int>>(this->threads);
+            this->heavyArcs = std::vector<char>(this->threads, false);
+            this->ownerStats = std::vector<SearchStats>(this->threads);
+            this->bucket = 0;
+            this->heavy = false;
+            this->relaxing = false;
+            this->finished = false;
+            this->round = 0;
+            this->roundStats = SearchStats();
+
+            distance->at(source) = E();
+            this->buckets.at(source % this->threads).push_back(std::vector<int>(1, source));
+
+            StepBarrier barrier(this->threads);
+            std::vector<std::thread> workers;
+            for (unsigned int i = 1; i < this->threads; i++) {
+                workers.push_back(std::thread(&DeltaStepping<V, E>::run, this, i, &barrier));
+            }
+            this->run(0, &barrier);
+
+            for (std::thread &t : workers) {
+                t.join();
+            }
+
+            SEARCH_STATS(for (SearchStats &owner : this->ownerStats) { this->roundStats.nodesGenerated += owner.nodesGenerated; })
+            SEARCH_STATS(if (stats != nullptr) { stats->nodesExpanded += this->roundStats.nodesExpanded; stats->nodesGenerated += this->roundStats.nodesGenerated; })
+        }
+};
+
+#endif
@@ -0,0 +1,592 @@
+/**
+ * GraphSearch holds the searches every graph representation runs through
+ *
+ * A graph only has to model the following concept (checked at compile time when a search is instantiated):
+ *
+ *     typedef ... Cost;                                          // Type of arc costs
+ *     typedef ... VertexId;                                      // Handle of a vertex (ints are taken to be 0 .. numVertices() - 1)
+ *     typedef ... ArcId;                                         // Handle of an arc, which is what paths are made of
+ *     int numVertices();
+ *     template <typename F> void forEachArc(VertexId v, F visit);         // Calls visit(ArcId arc, VertexId head, Cost cost) per outgoing arc
+ *     template <typename F> void forEachIncomingArc(VertexId v, F visit); // Calls visit(ArcId arc, VertexId tail, Cost cost) per incoming arc
+ *
+ * forEachIncomingArc is only needed by the bidirectional searches. Heuristics are any callable taking two vertex ids and
+ * returning a Cost. Nothing is virtual, so the searches compile down to direct loops over whichever representation they are given.
+ */
+#ifndef GRAPH_SEARCH
+#define GRAPH_SEARCH
+
+#include <queue>
+#include <set>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include "./stats.hpp"
+#include "./reservation-table.hpp"
+
+// VertexTable holds a record per vertex reached, hashed by vertex id
+template <typename VertexId, typename T>
+class VertexTable {
+    private:
+        std::unordered_map<VertexId, T> records;
+
+    public:
+        VertexTable(int) {}
+
+        // Get the record of a vertex (creating an unreached record if there is none)
+        T &operator [] (VertexId vertex) {
+            return this->records[vertex];
+        }
+
+        // Get the record of a vertex (or nullptr if there is none)
+        T *find(VertexId vertex) {
+            typename std::unordered_map<VertexId, T>::iterator it = this->records.find(vertex);
+            return it == this->records.end() ? nullptr : &it->second;
+        }
+};
+
+// VertexTable specialization for dense integer ids, which indexes a vector instead of hashing
+// The vector is kept by the searching thread and reused by its later searches. Each entry is stamped with the table that last
+// wrote it, so a search only pays for the vertices it reaches instead of clearing a record for every vertex of the graph
+template <typename T>
+class VertexTable<int, T> {
+    private:
+        // Records reused between tables, and the generation of the table each one was written by
+        struct Storage {
+            std::vector<T> records;
+            std::vector<unsigned int> stamps;
+            unsigned int generation = 0;
+        };
+
+        Storage *storage;
+
+        // Get the storage this thread has free for its next tables (a search can hold more than one table at once)
+        static std::vector<std::unique_ptr<Storage>> &freeStorage() {
+            static thread_local std::vector<std::unique_ptr<Storage>> storage;
+            return storage;
+        }
+
+    public:
+        VertexTable(int numVertices) {
+            std::vector<std::unique_ptr<Storage>> &available = freeStorage();
+            if (available.size() > 0) {
+                this->storage = available.back().release();
+                available.pop_back();
+            } else {
+                this->storage = new Storage();
+            }
+
+            if ((int) this->storage->records.size() < numVertices) {
+                this->storage->records.resize(numVertices);
+                this->storage->stamps.resize(numVertices, 0);
+            }
+
+            // Start a new generation, clearing the stamps once the counter wraps around
+            this->storage->generation++;
+            if (this->storage->generation == 0) {
+                std::fill(this->storage->stamps.begin(), this->storage->stamps.end(), 0);
+                this->storage->generation = 1;
+            }
+        }
+
+        ~VertexTable() {
+            freeStorage().push_back(std::unique_ptr<Storage>(this->storage));
+        }
+
+        VertexTable(const VertexTable &) = delete;
+        VertexTable &operator = (const VertexTable &) = delete;
+
+        // Get the record of a vertex (resetting it to an unreached record if this table hasn't written it yet)
+        T &operator [] (int vertex) {
+            if (this->storage->stamps[vertex] != this->storage->generation) {
+                this->storage->stamps[vertex] = this->storage->generation;
+                this->storage->records[vertex] = T();
+            }
+            return this->storage->records[vertex];
+        }
+
+        // Get the record of a vertex (or nullptr if this table hasn't written it)
+        T *find(int vertex) {
+            return this->storage->stamps[vertex] == this->storage->generation ? &this->storage->records[vertex] : nullptr;
+        }
+};
+
+// GraphSearch contains static searches over a graph that models the concept above
+template <typename Graph>
+class GraphSearch {
+    public:
+        typedef typename Graph::Cost E;
+        typedef typename Graph::VertexId VertexId;
+        typedef typename Graph::ArcId ArcId;
+
+        // Record kept for each vertex a search reaches
+        struct Record {
+            E costSoFar = E();
+            E cost = E();        // Estimated total cost
+            VertexId parent = VertexId();
+            ArcId arc = ArcId(); // Arc the vertex was reached through
+            char state = 0;      // 0 unreached, 1 open, 2 closed
+        };
+
+        // Dijkstra's algorithm, which finds the shortest path between two vertices
+        static bool dijkstras(std::vector<ArcId> *path, Graph *graph, VertexId startVertex, VertexId endVertex, SearchStats *stats = nullptr) {
+            return astar(path, graph, startVertex, endVertex, [](VertexId, VertexId) { return E(); }, stats);
+        }
+
+        // A* algorithm, which uses dijkstra's algorithm plus a heuristic
+        template <typename H>
+        static bool astar(std::vector<ArcId> *path, Graph *graph, VertexId startVertex, VertexId endVertex, H heuristic, SearchStats *stats = nullptr) {
+            VertexId reached;
+            return bestFirstSearch(path, &reached, graph, startVertex, [endVertex](VertexId vertex) {
+                return vertex == endVertex;
+            }, [&heuristic, endVertex](VertexId vertex) {
+                return heuristic(vertex, endVertex);
+            }, stats);
+        }
+
+        // Weighted A* algorithm, which inflates the heuristic by (1 + epsilon) to expand fewer vertices
+        // With a consistent heuristic the path cost is at most (1 + epsilon) times the optimal cost, without reopening closed vertices
+        template <typename H>
+        static bool weightedAstar(std::vector<ArcId> *path, Graph *graph, VertexId startVertex, VertexId endVertex, H heuristic, float epsilon, SearchStats *stats = nullptr) {
+            float weight = 1 + epsilon;
+
+            VertexId reached;
+            return bestFirstSearch(path, &reached, graph, startVertex, [endVertex](VertexId vertex) {
+                return vertex == endVertex;
+            }, [&heuristic, endVertex, weight](VertexId vertex) {
+                return inflate(weight, heuristic(vertex, endVertex));
+            }, stats, false);
+        }
+
+        // Focal A* (A*epsilon), which expands the open vertex closest to the goal out of every vertex whose estimated cost is within (1 + epsilon) of the best
+        // With an admissible heuristic the path cost is at most (1 + epsilon) times the optimal cost
+        template <typename H>
+        static bool focalAstar(std::vector<ArcId> *path, Graph *graph, VertexId startVertex, VertexId endVertex, H heuristic, float epsilon, SearchStats *stats = nullptr) {
+            VertexId reached;
+            return bestFirstSearch(path, &reached, graph, startVertex, [endVertex](VertexId vertex) {
+                return vertex == endVertex;
+            }, [&heuristic, endVertex](VertexId vertex) {
+                return heuristic(vertex, endVertex);
+            }, stats, true, 1 + epsilon);
+        }
+
+        // Multi-goal search, which runs a single A* search (Dijkstra's with a zero heuristic) that stops at the first goal reached
+        template <typename H>
+        static bool nearestGoal(std::vector<ArcId> *path, int *reachedGoal, Graph *graph, VertexId startVertex, const std::vector<VertexId> &goals, H heuristic, SearchStats *stats = nullptr) {
+            *reachedGoal = -1;
+            if (goals.size() == 0) {
+                return false;
+            }
+
+            // The smallest estimate to any goal stays admissible if the heuristic is admissible
+            VertexId reached;
+            bool success = bestFirstSearch(path, &reached, graph, startVertex, [&goals](VertexId vertex) {
+                return std::find(goals.begin(), goals.end(), vertex) != goals.end();
+            }, [&heuristic, &goals](VertexId vertex) {
+                E estimate = heuristic(vertex, goals.at(0));
+                for (typename std::vector<VertexId>::size_type i = 1; i < goals.size(); i++) {
+                    estimate = std::min<E>(estimate, heuristic(vertex, goals.at(i)));
+                }
+                return estimate;
+            }, stats);
+
+            if (success) {
+                *reachedGoal = std::find(goals.begin(), goals.end(), reached) - goals.begin();
+            }
+            return success;
+        }
+
+        // Bidirectional Dijkstra's algorithm, which searches forward from the start and backward from the end until the searches meet
+        static bool bidirectionalDijkstra(std::vector<ArcId> *path, Graph *graph, VertexId startVertex, VertexId endVertex, SearchStats *stats = nullptr) {
+            return bidirectionalAstar(path, graph, startVertex, endVertex, [](VertexId, VertexId) { return E(); }, stats);
+        }
+
+        // Bidirectional A* algorithm, which searches forward over outgoing arcs and backward over incoming arcs, always expanding the smaller frontier
+        // Both directions use the average potential (h(v, end) - h(v, start)) / 2, which keeps reduced arc costs non-negative, so the
+        // heuristic should be consistent and symmetric (estimate(a, b) == estimate(b, a)). Costs are kept doubled so the potential stays exact for integer costs
+        template <typename H>
+        static bool bidirectionalAstar(std::vector<ArcId> *path, Graph *graph, VertexId startVertex, VertexId endVertex, H heuristic, SearchStats *stats = nullptr) {
+            SEARCH_STATS(SearchTimer timer(stats);)
+
+            if (startVertex == endVertex) {
+                return true;
+            }
+
+            // Index 0 searches forward from the start, index 1 searches backward from the end
+            VertexTable<VertexId, Record> records[2] = {VertexTable<VertexId, Record>(graph->numVertices()), VertexTable<VertexId, Record>(graph->numVertices())};
+            OpenList openList[2];
+            int openCount[2] = {0, 0};
+            VertexId roots[2] = {startVertex, endVertex};
+
+            // Get the doubled potential of a vertex for a direction
+            auto potential = [&heuristic, startVertex, endVertex](VertexId vertex, int direction) -> E {
+                E difference = heuristic(vertex, endVertex) - heuristic(vertex, startVertex);
+                return direction == 0 ? difference : -difference;
+            };
+
+            for (int direction = 0; direction < 2; direction++) {
+                Record &root = records[direction][roots[direction]];
+                root.cost = potential(roots[direction], direction);
+                root.state = 1;
+                openList[direction].push(OpenEntry{root.cost, root.costSoFar, roots[direction]});
+                openCount[direction]++;
+                SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; })
+            }
+
+            // Best path found so far, through the meeting vertex
+            VertexId meeting = VertexId();
+            bool met = false;
+            E best = E();
+
+            while (true) {
+                // Drop stale entries so the tops are the real frontier minimums
+                for (int direction = 0; direction < 2; direction++) {
+                    while (openList[direction].size() > 0 && isStale(records[direction], openList[direction].top())) {
+                        openList[direction].pop();
+                    }
+                }
+                if (openList[0].size() == 0 || openList[1].size() == 0) {
+                    break;
+                }
+
+                // Stop once neither frontier can lead to a shorter path
+                if (met && openList[0].top().cost + openList[1].top().cost >= 2 * best) {
+                    break;
+                }
+
+                // Expand the smaller frontier
+                int direction = openCount[0] <= openCount[1] ? 0 : 1;
+                VertexId v = openList[direction].top().vertex;
+                openList[direction].pop();
+
+                Record &current = records[direction][v];
+                current.state = 2;
+                openCount[direction]--;
+                SEARCH_STATS(if (stats != nullptr) { stats->nodesExpanded++; })
+
+                // Relax each arc leading away from the root of this direction
+                auto relax = [&](ArcId arc, VertexId w, E cost) {
+                    E newCost = records[direction][v].costSoFar + cost;
+
+                    // Reduced costs are non-negative, so closed vertices are final
+                    Record &record = records[direction][w];
+                    if (record.state == 2 || (record.state == 1 && record.costSoFar <= newCost)) {
+                        return;
+                    }
+
+                    if (record.state == 0) {
+                        record.cost = 2 * newCost + potential(w, direction);
+                        openCount[direction]++;
+                    } else {
+                        record.cost = 2 * newCost + (record.cost - 2 * record.costSoFar);
+                    }
+                    record.costSoFar = newCost;
+                    record.parent = v;
+                    record.arc = arc;
+                    record.state = 1;
+                    openList[direction].push(OpenEntry{record.cost, record.costSoFar, w});
+                    SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; })
+
+                    // Check if this joins up with the other search
+                    Record *other = records[1 - direction].find(w);
+                    if (other != nullptr && other->state != 0 && (!met || newCost + other->costSoFar < best)) {
+                        meeting = w;
+                        met = true;
+                        best = newCost + other->costSoFar;
+                    }
+                };
+                if (direction == 0) {
+                    graph->forEachArc(v, relax);
+                } else {
+                    graph->forEachIncomingArc(v, relax);
+                }
+                SEARCH_STATS(if (stats != nullptr) { stats->recordOpenList(openCount[0] + openCount[1]); })
+            }
+
+            if (!met) {
+                return false;
+            }
+
+            // Compile the forward half of the path back from the meeting vertex
+            for (VertexId v = meeting; v != startVertex; v = records[0][v].parent) {
+                path->push_back(records[0][v].arc);
+            }
+            std::reverse(std::begin(*path), std::end(*path));
+
+            // Then the backward half on to the end vertex
+            for (VertexId v = meeting; v != endVertex; v = records[1][v].parent) {
+                path->push_back(records[1][v].arc);
+            }
+
+            SEARCH_STATS(if (stats != nullptr) { stats->pathLength += path->size(); })
+            return true;
+        }
+
+        // Windowed cooperative A* (WHCA*), which searches space-time around other agents' reservations for a given window of timesteps
+        // The timed path holds the vertex the agent should be on at each timestep (waits repeat a vertex, and waiting costs 1)
+        template <typename H>
+        static bool cooperativeAstar(std::vector<VertexId> *timedPath, Graph *graph, VertexId startVertex, VertexId endVertex, H heuristic, ReservationTable<VertexId> *table, int agent, int startTime, int window, SearchStats *stats = nullptr) {
+            SEARCH_STATS(SearchTimer timer(stats);)
+
+            // Every record ever generated (the open list holds indices into it)
+            std::vector<SpaceTimeRecord> records;
+            std::set<std::pair<VertexId, int>> closed;
+
+            // Order the open list by estimated cost, preferring records that are further along
+            auto compare = [&records](int a, int b) {
+                if (records.at(a).cost != records.at(b).cost) {
+                    return records.at(a).cost > records.at(b).cost;
+                }
+                return records.at(a).costSoFar < records.at(b).costSoFar;
+            };
+            std::priority_queue<int, std::vector<int>, decltype(compare)> openList(compare);
+
+            // Initialize the record for the start node
+            SpaceTimeRecord start;
+            start.vertex = startVertex;
+            start.time = startTime;
+            start.parent = -1;
+            start.costSoFar = E();
+            start.cost = heuristic(startVertex, endVertex);
+            records.push_back(start);
+            openList.push(0);
+            SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; stats->recordOpenList(openList.size()); })
+
+            // Iterate through processing each space-time vertex
+            int current = -1;
+            bool found = false;
+            while (openList.size() > 0) {
+                current = openList.top();
+                openList.pop();
+
+                SpaceTimeRecord record = records.at(current);
+                if (closed.find(std::make_pair(record.vertex, record.time)) != closed.end()) {
+                    continue;
+                }
+                closed.insert(std::make_pair(record.vertex, record.time));
+                SEARCH_STATS(if (stats != nullptr) { stats->nodesExpanded++; })
+
+                // Stop at the goal, or at the end of the window (where the heuristic estimates the rest of the path)
+                if (record.vertex == endVertex || record.time - startTime >= window) {
+                    found = true;
+                    break;
+                }
+
+                // Waiting in place is always an option if nobody else needs the vertex
+                auto move = [&](ArcId, VertexId w, E cost) {
+                    int time = record.time + 1;
+
+                    // Skip moves that would collide with another agent's reservations
+                    if (closed.find(std::make_pair(w, time)) != closed.end() || table->isReserved(w, time, agent) || table->isSwap(record.vertex, w, record.time, agent)) {
+                        return;
+                    }
+
+                    SpaceTimeRecord next;
+                    next.vertex = w;
+                    next.time = time;
+                    next.parent = current;
+                    next.costSoFar = record.costSoFar + cost;
+                    next.cost = next.costSoFar + heuristic(w, endVertex);
+
+                    records.push_back(next);
+                    openList.push(records.size() - 1);
+                    SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; })
+                };
+                move(ArcId(), record.vertex, (E) 1);
+                graph->forEachArc(record.vertex, move);
+                SEARCH_STATS(if (stats != nullptr) { stats->recordOpenList(openList.size()); })
+            }
+
+            if (!found) {
+                return false;
+            }
+
+            // Compile the list of vertices for each timestep
+            for (int i = current; i != -1; i = records.at(i).parent) {
+                timedPath->push_back(records.at(i).vertex);
+            }
+
+            std::reverse(std::begin(*timedPath), std::end(*timedPath));
+            SEARCH_STATS(if (stats != nullptr) { stats->pathLength += timedPath->size() - 1; })
+            return true;
+        }
+
+    private:
+        // Entry of the open list (an entry goes stale once its vertex closes or is reached more cheaply, and is skipped when popped)
+        struct OpenEntry {
+            E cost;
+            E costSoFar;
+            VertexId vertex;
+
+            // Order entries by estimated cost, preferring entries that are further along
+            bool operator > (const OpenEntry &entry) const {
+                if (this->cost != entry.cost) {
+                    return this->cost > entry.cost;
+                }
+                return this->costSoFar < entry.costSoFar;
+            }
+        };
+        typedef std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> OpenList;
+
+        // Record of a vertex at a given timestep in cooperative A*
+        struct SpaceTimeRecord {
+            VertexId vertex;
+            int time;
+            int parent;  // Index of the parent record (-1 for the start record)
+            E cost;      // Estimated total cost
+            E costSoFar;
+        };
+
+        // Return true if an open list entry no longer matches its vertex's record
+        static bool isStale(VertexTable<VertexId, Record> &records, const OpenEntry &entry) {
+            Record &record = records[entry.vertex];
+            return record.state != 1 || record.costSoFar != entry.costSoFar;
+        }
+
+        // Best-first search shared by the A* variants and nearestGoal, which stops at the first vertex isGoal accepts (returned through reached)
+        // estimate gives the part of a vertex's estimated cost still to go, so an estimate of 0 everywhere makes this Dijkstra's algorithm
+        // Closed vertices are only reopened if reopen is set. A focal weight above 1 expands the vertex with the smallest estimate out of
+        // every open vertex whose estimated cost is within that factor of the best, keeping the open vertices ordered both ways
+        template <typename G, typename F>
+        static bool bestFirstSearch(std::vector<ArcId> *path, VertexId *reached, Graph *graph, VertexId startVertex, G isGoal, F estimate, SearchStats *stats, bool reopen = true, float focalWeight = 1) {
+            SEARCH_STATS(SearchTimer timer(stats);)
+
+            VertexTable<VertexId, Record> records(graph->numVertices());
+            OpenList openList;
+            int openCount = 0;
+
+            // Focal searches keep the open vertices ordered by estimated cost, and the focal list (every open vertex whose
+            // estimated cost is within the focal bound) ordered by the estimate left. Vertices that fall outside of a shrinking
+            // bound are only dropped from the focal list once they reach its front
+            bool focal = focalWeight > 1;
+            std::set<std::pair<E, VertexId>> openByCost;
+            std::set<std::pair<E, VertexId>> focalList;
+            E focalBound = E();
+
+            // Open a vertex, or move it if it is already open
+            auto open = [&](VertexId v, E costSoFar, E cost) {
+                Record &record = records[v];
+                if (focal && record.state == 1) {
+                    openByCost.erase(std::make_pair(record.cost, v));
+                    focalList.erase(std::make_pair(record.cost - record.costSoFar, v));
+                }
+                if (record.state != 1) {
+                    openCount++;
+                }
+
+                record.costSoFar = costSoFar;
+                record.cost = cost;
+                record.state = 1;
+
+                if (focal) {
+                    openByCost.insert(std::make_pair(cost, v));
+                    if (cost <= focalBound) {
+                        focalList.insert(std::make_pair(cost - costSoFar, v));
+                    }
+                } else {
+                    openList.push(OpenEntry{cost, costSoFar, v});
+                }
+                SEARCH_STATS(if (stats != nullptr) { stats->nodesGenerated++; })
+            };
+
+            open(startVertex, E(), estimate(startVertex));
+            SEARCH_STATS(if (stats != nullptr) { stats->recordOpenList(openCount); })
+
+            // Iterate through processing each vertex
+            VertexId current = VertexId();
+            bool found = false;
+            while (openCount > 0) {
+                if (focal) {
+                    // Move the focal bound with the best estimated cost, adding the vertices it now takes in
+                    E bound = inflate(focalWeight, openByCost.begin()->first);
+                    if (bound > focalBound) {
+                        for (typename std::set<std::pair<E, VertexId>>::iterator it = openByCost.lower_bound(std::make_pair(focalBound, VertexId())); it != openByCost.end() && it->first <= bound; it++) {
+                            focalList.insert(std::make_pair(it->first - records[it->second].costSoFar, it->second));
+                        }
+                    }
+                    focalBound = bound;
+
+                    current = focalList.begin()->second;
+                    focalList.erase(focalList.begin());
+                    if (records[current].cost > focalBound) {
+                        continue;
+                    }
+                    openByCost.erase(std::make_pair(records[current].cost, current));
+                } else {
+                    // Get the smallest element in the open list
+                    OpenEntry entry = openList.top();
+                    openList.pop();
+                    if (isStale(records, entry)) {
+                        continue;
+                    }
+                    current = entry.vertex;
+                }
+                records[current].state = 2;
+                openCount--;
+                SEARCH_STATS(if (stats != nullptr) { stats->nodesExpanded++; })
+
+                // If the current vertex is a goal, break
+                if (isGoal(current)) {
+                    found = true;
+                    break;
+                }
+
+                // Loop through each arc of the vertex
+                graph->forEachArc(current, [&](ArcId arc, VertexId w, E cost) {
+                    E newCost = records[current].costSoFar + cost;
+
+                    Record &record = records[w];
+                    if (record.state == 0) {
+                        record.parent = current;
+                        record.arc = arc;
+                        open(w, newCost, newCost + estimate(w));
+                        return;
+                    }
+
+                    // Skip if we didn't find a shorter route (or closed vertices stay closed)
+                    if ((record.state == 2 && !reopen) || record.costSoFar <= newCost) {
+                        return;
+                    }
+                    SEARCH_STATS(if (stats != nullptr && record.state == 2) { stats->reopened++; })
+
+                    // Keep the estimate we already have, and update the costs
+                    record.parent = current;
+                    record.arc = arc;
+                    open(w, newCost, newCost + (record.cost - record.costSoFar));
+                });
+                SEARCH_STATS(if (stats != nullptr) { stats->recordOpenList(openCount); })
+            }
+
+            // Make sure we've reached a goal vertex
+            if (!found) {
+                return false;
+            }
+            *reached = current;
+
+            // Compile a list of arcs we took to get to this path
+            for (VertexId v = current; v != startVertex; v = records[v].parent) {
+                path->push_back(records[v].arc);
+            }
+
+            // Return the reversed path
+            std::reverse(std::begin(*path), std::end(*path));
+            SEARCH_STATS(if (stats != nullptr) { stats->pathLength += path->size(); })
+            return true;
+        }
+
+        // Inflate an estimate by a weight, rounding down for integer costs so the inflated estimate never exceeds weight times the estimate
+        static E inflate(float weight, E estimate) {
+            if constexpr (std::is_integral<E>::value) {
+                return (E) std::floor(weight * estimate);
+            } else {
+                return weight * estimate;
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * HashDistributedAstar runs a single A* query across several threads
+ *
+ * Every vertex is owned by one worker, picked by hashing the vertex. A worker only expands vertices it owns
+ * and sends every other vertex it generates to its owner's inbox. Workers keep searching until no open
+ * vertex could lead to a cheaper path than the best one found, and no messages are still in flight.
+ *
+ * Adapted from "Best-First Heuristic Search for Multicore Machines" by Kishimoto, Fukunaga and Botea (HDA*)
+ */
+#ifndef HDA_STAR
+#define HDA_STAR
+
+#include <queue>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include "../graph/graph.hpp"
+#include "./heuristic.hpp"
+#include "./stats.hpp"
+
+// HashDistributedAstar holds the shared state of one parallel A* query
+template <typename V, typename E>
+class HashDistributedAstar {
+    private:
+        // Message carries a generated vertex to the worker that owns it
+        struct Message {
+            Vertex<V> *vertex;
+            Vertex<V> *parent;
+            Edge<E> *edge;
+            E costSoFar;
+        };
+
+        // Record is what a worker knows about one of its vertices
+        struct Record {
+            Vertex<V> *parent;
+            Edge<E> *edge;
+            E costSoFar;
+        };
+
+        // OpenEntry orders a worker's open list by estimated total cost
+        struct OpenEntry {
+            E cost;
+            E costSoFar;
+            Vertex<V> *vertex;
+
+            bool operator > (const OpenEntry &entry) const {
+                return this->cost > entry.cost;
+            }
+        };
+
+        // Worker is the state owned by one thread
+        struct Worker {
+            std::unordered_map<Vertex<V>*, Record> records;
+            std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> openList;
+            std::vector<std::vector<Message>> outboxes; // Messages waiting to be sent to each other worker
+
+            std::mutex inboxLock;
+            std::vector<Message> inbox;
+
+            std::atomic<bool> idle;
+            SearchStats stats;
+        };
+
+        AdjacencyListGraph<V, E> *graph;
+        Heuristic<V, E> *heuristic;
+        Vertex<V> *startVertex;
+        Vertex<V> *endVertex;
+
+        std::vector<Worker*> workers;
+        unsigned int threads;
+
+        // Termination detection counts every message sent and received
+        std::atomic<long> sent;
+        std::atomic<long> received;
+        std::atomic<bool> done;
+
+        // Cost of the best path to the end vertex found so far (read freely, only updated under the lock)
+        std::mutex incumbentLock;
+        std::atomic<bool> found;
+        std::atomic<E> incumbent;
+
+        // Outboxes are flushed once they hold this many messages (and whenever a worker runs out of work)
+        static const std::size_t batchSize = 64;
+
+        // Pick the worker that owns a vertex (pointers are mixed so aligned allocations still spread evenly)
+        unsigned int owner(Vertex<V> *vertex) {
+            uint64_t hash = (uint64_t) (uintptr_t) vertex;
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            return hash % this->threads;
+        }
+
+        // Return true if a path with this estimated cost could still beat the best path found
+        bool isPromising(E cost) {
+            // The incumbent is stored before found is set, so seeing found means the incumbent is already there
+            return !this->found || cost < this->incumbent;
+        }
+
+        // Offer a vertex to its owner (which is this worker) and open it if it is cheaper than what the owner knew
+        void offer(Worker *worker, Message &message) {
+            typename std::unordered_map<Vertex<V>*, Record>::iterator it = worker->records.find(message.vertex);
+            if (it != worker->records.end() && it->second.costSoFar <= message.costSoFar) {
+                return;
+            }
+
+            Record record;
+            record.parent = message.parent;
+            record.edge = message.edge;
+            record.costSoFar = message.costSoFar;
+
+            if (it != worker->records.end()) {
+                SEARCH_STATS(worker->stats.reopened++;)
+                it->second = record;
+            } else {
+                worker->records[message.vertex] = record;
+            }
+
+            OpenEntry entry;
+            entry.vertex = message.vertex;
+            entry.costSoFar = message.costSoFar;
+            entry.cost = message.costSoFar + this->heuristic->estimate(message.vertex, this->endVertex);
+            worker->openList.push(entry);
+            SEARCH_STATS(worker->stats.nodesGenerated++;)
+            SEARCH_STATS(worker->stats.recordOpenList(worker->openList.size());)
+        }
+
+        // Send every waiting message to its owner's inbox
+        void flush(Worker *worker, bool force) {
+            for (unsigned int i = 0; i < this->threads; i++) {
+                std::vector<Message> &outbox = worker->outboxes.at(i);
+                if (outbox.size() == 0 || (!force && outbox.size() < batchSize)) {
+                    continue;
+                }
+
+                this->sent += outbox.size();
+                {
+                    std::lock_guard<std::mutex> guard(this->workers.at(i)->inboxLock);
+                    std::vector<Message> &inbox = this->workers.at(i)->inbox;
+                    inbox.insert(inbox.end(), outbox.begin(), outbox.end());
+                }
+                outbox.clear();
+            }
+        }
+
+        // Take the messages waiting in a worker's inbox (returns false if there were none)
+        bool drain(Worker *worker) {
+            std::vector<Message> messages;
+            {
+                std::lock_guard<std::mutex> guard(worker->inboxLock);
+                messages.swap(worker->inbox);
+            }
+            if (messages.size() == 0) {
+                return false;
+            }
+
+            // Mark ourselves busy before the messages count as received, so termination can't be detected in between
+            worker->idle = false;
+            for (Message &message : messages) {
+                this->offer(worker, message);
+            }
+            this->received += messages.size();
+
+            return true;
+        }
+
+        // Return true if every worker is idle
+        bool allIdle() {
+            for (Worker *worker : this->workers) {
+                if (!worker->idle) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Run one worker until the search is done
+        void run(unsigned int id) {
+            Worker *worker = this->workers.at(id);
+
+            while (!this->done) {
+                this->drain(worker);
+
+                // Drop open vertices that were improved since they were pushed or that can't beat the best path
+                while (worker->openList.size() > 0) {
+                    OpenEntry top = worker->openList.top();
+                    if (worker->records.at(top.vertex).costSoFar < top.costSoFar) {
+                        worker->openList.pop();
+                    } else if (!this->isPromising(top.cost)) {
+                        worker->openList = std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>>();
+                    } else {
+                        break;
+                    }
+                }
+
+                if (worker->openList.size() == 0) {
+                    // Out of work, so send everything we have and check whether the whole search is finished
+                    this->flush(worker, true);
+                    worker->idle = true;
+
+                    if (id == 0 && this->allIdle()) {
+                        long sentBefore = this->sent;
+                        long receivedBefore = this->received;
+
+                        // Check twice, so nothing can have been sent or received in between
+                        if (sentBefore == receivedBefore && this->allIdle() && this->sent == sentBefore && this->received == receivedBefore) {
+                            this->done = true;
+                        }
+                    }
+
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                worker->idle = false;
+                OpenEntry current = worker->openList.top();
+                worker->openList.pop();
+                SEARCH_STATS(worker->stats.nodesExpanded++;)
+
+                // Reaching the end vertex gives a new best path, but other workers may still find a cheaper one
+                if (current.vertex == this->endVertex) {
+                    std::lock_guard<std::mutex> guard(this->incumbentLock);
+                    if (!this->found || current.costSoFar < this->incumbent) {
+                        this->incumbent = current.costSoFar;
+                        this->found = true;
+                    }
+                    continue;
+                }
+
+                // Generate each neighbour, keeping our own and sending the rest to their owners
+                for (Edge<E> *e : *this->graph->outgoingEdges(current.vertex)) {
+                    Message message;
+                    message.vertex = this->graph->opposite(current.vertex, e);
+                    message.parent = current.vertex;
+                    message.edge = e;
+                    message.costSoFar = current.costSoFar + e->getElement();
+
+                    unsigned int messageOwner = this->owner(message.vertex);
+                    if (messageOwner == id) {
+                        this->offer(worker, message);
+                    } else {
+                        worker->outboxes.at(messageOwner).push_back(message);
+                    }
+                }
+
+                this->flush(worker, false);
+            }
+        }
+
+    public:
+        // Setup a query over a graph using a number of threads (0 uses every hardware thread)
+        HashDistributedAstar(AdjacencyListGraph<V, E> *graph, Vertex<V> *startVertex, Vertex<V> *endVertex, Heuristic<V, E> *heuristic, unsigned int threads = 0) {
+            this->graph = graph;
+            this->startVertex = startVertex;
+            this->endVertex = endVertex;
+            this->heuristic = heuristic;
+            this->threads = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+
+            this->sent = 0;
+            this->received = 0;
+            this->done = false;
+            this->found = false;
+            this->incumbent = E();
+
+            for (unsigned int i = 0; i < this->threads; i++) {
+                Worker *worker = new Worker();
+                worker->outboxes = std::vector<std::vector<Message>>(this->threads);
+                worker->idle = false;
+                this->workers.push_back(worker);
+            }
+        }
+
+        ~HashDistributedAstar() {
+            for (Worker *worker : this->workers) {
+                delete worker;
+            }
+        }
+
+        // Run the query (returns false if there is no path)
+        // The open list peak added to the stats is the sum of every worker's own peak. The workers needn't peak at the same
+        // time, so this is an upper bound on the largest number of vertices that were open at once
+        bool search(std::vector<Edge<E>*> *path, SearchStats *stats = nullptr) {
+            SEARCH_STATS(SearchTimer timer(stats);)
+
+            // Hand the start vertex to its owner
+            Message start;
+            start.vertex = this->startVertex;
+            start.parent = nullptr;
+            start.edge = nullptr;
+            start.costSoFar = E();
+            this->offer(this->workers.at(this->owner(this->startVertex)), start);
+
+            std::vector<std::thread> threads;
+            for (unsigned int i = 1; i < this->threads; i++) {
+                threads.push_back(std::thread(&HashDistributedAstar<V, E>::run, this, i));
+            }
+            this->run(0);
+
+            for (std::thread &t : threads) {
+                t.join();
+            }
+
+            SEARCH_STATS(if (stats != nullptr) { for (Worker *worker : this->workers) { stats->nodesExpanded += worker->stats.nodesExpanded; stats->nodesGenerated += worker->stats.nodesGenerated; stats->reopened += worker->stats.reopened; stats->openListPeak += worker->stats.openListPeak; } })
+
+            if (!this->found) {
+                return false;
+            }
+
+            // Follow the parents back from the end vertex, through whichever workers own them
+            for (Vertex<V> *vertex = this->endVertex; vertex != this->startVertex;) {
+                Record &record = this->workers.at(this->owner(vertex))->records.at(vertex);
+                path->push_back(record.edge);
+                vertex = record.parent;
+            }
+
+            std::reverse(std::begin(*path), std::end(*path));
+            SEARCH_STATS(if (stats != nullptr) { stats->pathLength += path->size(); })
+            return true;
+        }
+};
+
+#endif
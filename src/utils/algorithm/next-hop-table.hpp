@@ -0,0 +1,247 @@
+/**
+ * NextHopTable holds all-pairs shortest path distances and next-hop edges for small static graphs
+ *
+ * The table is built by running Dijkstra's algorithm from every vertex in parallel, after which
+ * a path query is a walk of next-hop lookups. Tables can be saved next to the graph's asset so
+ * they only have to be built once.
+ */
+#ifndef NEXT_HOP_TABLE
+#define NEXT_HOP_TABLE
+
+#include <queue>
+#include <vector>
+#include <map>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include "../graph/graph.hpp"
+
+// NextHopTable maps every (source, destination) pair to the first edge of a shortest path between them
+template <typename V, typename E>
+class NextHopTable {
+    private:
+        // HopEdge is an outgoing edge by index, so workers never touch the graph itself
+        struct HopEdge {
+            int edge;   // Index into the graph's edge list
+            int target; // Index of the vertex the edge leads to
+            E weight;
+        };
+
+        AdjacencyListGraph<V, E> *graph;
+        std::vector<Vertex<V>*> vertexList;
+        std::vector<Edge<E>*> edgeList;
+        std::map<Vertex<V>*, int> vertexIndex;
+        std::vector<std::vector<HopEdge>> adjacency;
+
+        int n = 0;
+        std::vector<int> next;  // Row-major next-hop edge index (-1 if the destination is unreachable)
+        std::vector<E> distance; // Row-major shortest path distance
+
+        // Run Dijkstra's algorithm from a single source, filling in its row of the table
+        void buildRow(int source) {
+            std::vector<bool> closed(this->n, false);
+            int *nextRow = this->next.data() + (std::size_t) source * this->n;
+            E *distanceRow = this->distance.data() + (std::size_t) source * this->n;
+
+            std::priority_queue<std::pair<E, int>, std::vector<std::pair<E, int>>, std::greater<std::pair<E, int>>> open;
+            distanceRow[source] = E();
+            open.push(std::make_pair(E(), source));
+
+            while (!open.empty()) {
+                std::pair<E, int> current = open.top();
+                open.pop();
+
+                if (closed.at(current.second)) {
+                    continue;
+                }
+                closed.at(current.second) = true;
+
+                for (HopEdge &hop : this->adjacency.at(current.second)) {
+                    E cost = current.first + hop.weight;
+                    if (closed.at(hop.target) || (nextRow[hop.target] != -1 && !(cost < distanceRow[hop.target]))) {
+                        continue;
+                    }
+
+                    // The first hop is inherited from the vertex we came through (or is this edge when leaving the source)
+                    distanceRow[hop.target] = cost;
+                    nextRow[hop.target] = current.second == source ? hop.edge : nextRow[current.second];
+                    open.push(std::make_pair(cost, hop.target));
+                }
+            }
+
+            nextRow[source] = -1;
+        }
+
+    public:
+        // Constructor for a next-hop table over a graph (the table is empty until it is built or loaded)
+        NextHopTable(AdjacencyListGraph<V, E> *graph) {
+            this->graph = graph;
+            this->vertexList = graph->vertices();
+            this->edgeList = graph->edges();
+            this->n = this->vertexList.size();
+
+            std::map<Edge<E>*, int> edgeIndex;
+            for (int i = 0; i < this->n; i++) {
+                this->vertexIndex[this->vertexList.at(i)] = i;
+            }
+            for (typename std::vector<Edge<E>*>::size_type i = 0; i < this->edgeList.size(); i++) {
+                edgeIndex[this->edgeList.at(i)] = i;
+            }
+
+            this->adjacency = std::vector<std::vector<HopEdge>>(this->n);
+            for (int i = 0; i < this->n; i++) {
+                for (Edge<E> *e : *graph->outgoingEdges(this->vertexList.at(i))) {
+                    HopEdge hop;
+                    hop.edge = edgeIndex[e];
+                    hop.target = this->vertexIndex[graph->opposite(this->vertexList.at(i), e)];
+                    hop.weight = e->getElement();
+                    this->adjacency.at(i).push_back(hop);
+                }
+            }
+        }
+
+        // Build the table, running one Dijkstra search per vertex across a number of threads (0 uses every hardware thread)
+        void build(unsigned int threads = 0) {
+            if (threads == 0) {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            this->next = std::vector<int>((std::size_t) this->n * this->n, -1);
+            this->distance = std::vector<E>((std::size_t) this->n * this->n, E());
+
+            // Each worker takes the next unbuilt row until every row is done
+            std::atomic<int> nextSource(0);
+            std::function<void()> worker = [this, &nextSource]() {
+                for (int source = nextSource++; source < this->n; source = nextSource++) {
+                    this->buildRow(source);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned int i = 1; i < threads && (int) i < this->n; i++) {
+                workers.push_back(std::thread(worker));
+            }
+            worker();
+
+            for (std::thread &t : workers) {
+                t.join();
+            }
+        }
+
+        // Return true if the table has been built or loaded
+        bool isBuilt() {
+            return this->next.size() == (std::size_t) this->n * this->n;
+        }
+
+        // Return true if there is a path between two vertices
+        bool reachable(Vertex<V> *startVertex, Vertex<V> *endVertex) {
+            int start = this->vertexIndex.at(startVertex);
+            int end = this->vertexIndex.at(endVertex);
+
+            return start == end || this->next.at((std::size_t) start * this->n + end) != -1;
+        }
+
+        // Get the shortest path distance between two vertices (only meaningful if they are reachable)
+        E getDistance(Vertex<V> *startVertex, Vertex<V> *endVertex) {
+            return this->distance.at((std::size_t) this->vertexIndex.at(startVertex) * this->n + this->vertexIndex.at(endVertex));
+        }
+
+        // Get the first edge of the shortest path between two vertices (or nullptr if there is none)
+        Edge<E> *nextHop(Vertex<V> *startVertex, Vertex<V> *endVertex) {
+            int hop = this->next.at((std::size_t) this->vertexIndex.at(startVertex) * this->n + this->vertexIndex.at(endVertex));
+            return hop == -1 ? nullptr : this->edgeList.at(hop);
+        }
+
+        // Find the shortest path between two vertices by following next hops (returns false if there is no path)
+        bool path(std::vector<Edge<E>*> *path, Vertex<V> *startVertex, Vertex<V> *endVertex) {
+            path->clear();
+            if (!this->reachable(startVertex, endVertex)) {
+                return false;
+            }
+
+            int end = this->vertexIndex.at(endVertex);
+            int current = this->vertexIndex.at(startVertex);
+            while (current != end) {
+                int hop = this->next.at((std::size_t) current * this->n + end);
+                Edge<E> *edge = this->edgeList.at(hop);
+                path->push_back(edge);
+                current = this->vertexIndex.at(this->graph->opposite(this->vertexList.at(current), edge));
+            }
+
+            return true;
+        }
+
+        // Save the table to a file
+        bool save(std::string filename) {
+            std::ofstream file(filename);
+            if (!file.is_open() || !this->isBuilt()) {
+                return false;
+            }
+
+            file << "nexthop," << this->n << "," << this->edgeList.size() << "," << fingerprintGraph(this->graph) << "\n";
+            for (std::size_t i = 0; i < this->next.size(); i++) {
+                file << this->next.at(i) << "," << this->distance.at(i) << ((i + 1) % this->n == 0 ? "\n" : ",");
+            }
+
+            return true;
+        }
+
+        // Load a table from a file (returns false if it is missing, corrupt or was built for a different graph)
+        bool load(std::string filename) {
+            std::ifstream file(filename);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            // Check the header matches this graph
+            std::string header;
+            std::getline(file, header);
+
+            std::ostringstream expected;
+            expected << "nexthop," << this->n << "," << this->edgeList.size() << "," << fingerprintGraph(this->graph);
+            if (header != expected.str()) {
+                return false;
+            }
+
+            std::vector<int> next((std::size_t) this->n * this->n, -1);
+            std::vector<E> distance((std::size_t) this->n * this->n, E());
+
+            std::string buf;
+            for (std::size_t i = 0; i < next.size(); i++) {
+                if (!std::getline(file, buf, ',')) {
+                    return false;
+                }
+                if (!parseField(buf, &next.at(i))) {
+                    return false;
+                }
+
+                if (!std::getline(file, buf, (i + 1) % this->n == 0 ? '\n' : ',') || !parseField(buf, &distance.at(i))) {
+                    return false;
+                }
+
+                if (next.at(i) < -1 || next.at(i) >= (int) this->edgeList.size()) {
+                    return false;
+                }
+            }
+
+            this->next = next;
+            this->distance = distance;
+            return true;
+        }
+};
+
+// Load the next-hop table saved next to a graph's asset, building and saving it if it is missing or stale
+template <typename V, typename E>
+void loadOrBuildNextHopTable(NextHopTable<V, E> *table, std::string assetFilename) {
+    std::string tableFilename = assetFilename + ".nexthop";
+
+    if (!table->load(tableFilename)) {
+        table->build();
+        table->save(tableFilename);
+    }
+}
+
+#endif
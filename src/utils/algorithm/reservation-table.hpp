@@ -0,0 +1,94 @@
+/**
+ * ReservationTable holds (vertex, time) reservations shared between cooperatively pathfinding agents
+ *
+ * Used by windowed hierarchical cooperative A* (WHCA*), adapted from "Cooperative Pathfinding" by David Silver
+ */
+#ifndef RESERVATION_TABLE
+#define RESERVATION_TABLE
+
+#include <map>
+#include <vector>
+#include <utility>
+
+// ReservationTable maps a vertex (any vertex id a GraphSearch graph uses) at a given timestep to the agent that will occupy it
+template <typename VertexId>
+class ReservationTable {
+    private:
+        std::map<std::pair<VertexId, int>, int> reservations;
+        std::map<int, std::vector<std::pair<VertexId, int>>> agentReservations;
+
+    public:
+        // Reserve a vertex at a given timestep for an agent (returns false if another agent already holds it)
+        bool reserve(VertexId vertex, int time, int agent) {
+            std::pair<VertexId, int> key = std::make_pair(vertex, time);
+
+            typename std::map<std::pair<VertexId, int>, int>::iterator it = this->reservations.find(key);
+            if (it != this->reservations.end()) {
+                return it->second == agent;
+            }
+
+            this->reservations[key] = agent;
+            this->agentReservations[agent].push_back(key);
+            return true;
+        }
+
+        // Get the agent holding a vertex at a given timestep (or -1 if it is free)
+        int holder(VertexId vertex, int time) {
+            typename std::map<std::pair<VertexId, int>, int>::iterator it = this->reservations.find(std::make_pair(vertex, time));
+            if (it == this->reservations.end()) {
+                return -1;
+            }
+
+            return it->second;
+        }
+
+        // Return true if an agent other than the given one holds a vertex at a given timestep
+        bool isReserved(VertexId vertex, int time, int agent) {
+            int holder = this->holder(vertex, time);
+            return holder != -1 && holder != agent;
+        }
+
+        // Return true if an agent moving from one vertex to another between time and time + 1 would swap places with another agent
+        bool isSwap(VertexId from, VertexId to, int time, int agent) {
+            int holder = this->holder(to, time);
+            return holder != -1 && holder != agent && this->holder(from, time + 1) == holder;
+        }
+
+        // Release every reservation held by an agent
+        void release(int agent) {
+            for (std::pair<VertexId, int> key : this->agentReservations[agent]) {
+                this->reservations.erase(key);
+            }
+            this->agentReservations.erase(agent);
+        }
+
+        // Release every reservation before a given timestep
+        void releaseBefore(int time) {
+            typename std::map<int, std::vector<std::pair<VertexId, int>>>::iterator it = this->agentReservations.begin();
+            while (it != this->agentReservations.end()) {
+                std::vector<std::pair<VertexId, int>> kept;
+                for (std::pair<VertexId, int> key : it->second) {
+                    if (key.second < time) {
+                        this->reservations.erase(key);
+                    } else {
+                        kept.push_back(key);
+                    }
+                }
+
+                // Forget agents that no longer hold anything
+                if (kept.size() == 0) {
+                    it = this->agentReservations.erase(it);
+                } else {
+                    it->second = kept;
+                    it++;
+                }
+            }
+        }
+
+        // Return the number of reservations in the table
+        int size() {
+            return this->reservations.size();
+        }
+};
+
+#endif
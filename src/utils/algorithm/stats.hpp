@@ -0,0 +1,75 @@
+/**
+ * SearchStats records what a single pathfinding search cost
+ *
+ * Instrumentation is only compiled in when SEARCH_STATS_ENABLED is defined (run `make STATS=1`).
+ * Otherwise every SEARCH_STATS(...) statement expands to nothing and the stats pointers passed
+ * into the search functions are never touched.
+ */
+#ifndef SEARCH_STATS_HPP
+#define SEARCH_STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef SEARCH_STATS_ENABLED
+#define SEARCH_STATS(statement) statement
+#else
+#define SEARCH_STATS(statement)
+#endif
+
+// SearchStats holds counters for one search (or the sum of several searches)
+struct SearchStats {
+    long searches = 0;           // Number of searches that were recorded
+    long nodesExpanded = 0;      // Vertices popped off of the open list and expanded
+    long nodesGenerated = 0;     // Vertices pushed onto the open list (including reopened ones)
+    long reopened = 0;           // Vertices moved from the closed list back to the open list
+    std::size_t openListPeak = 0; // Largest size the open list reached
+    long pathLength = 0;         // Number of edges in the returned path
+    int64_t elapsedNanoseconds = 0; // Wall time spent inside the search
+
+    // Record the current size of the open list
+    void recordOpenList(std::size_t size) {
+        if (size > this->openListPeak) {
+            this->openListPeak = size;
+        }
+    }
+
+    // Add the counters of another set of stats to this one
+    void add(const SearchStats &other) {
+        this->searches += other.searches;
+        this->nodesExpanded += other.nodesExpanded;
+        this->nodesGenerated += other.nodesGenerated;
+        this->reopened += other.reopened;
+        this->pathLength += other.pathLength;
+        this->elapsedNanoseconds += other.elapsedNanoseconds;
+        if (other.openListPeak > this->openListPeak) {
+            this->openListPeak = other.openListPeak;
+        }
+    }
+};
+
+// SearchTimer adds the wall time of its own lifetime to a stats sink (if one was given)
+class SearchTimer {
+    private:
+        SearchStats *stats;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        SearchTimer(SearchStats *stats) {
+            this->stats = stats;
+            this->start = std::chrono::steady_clock::now();
+
+            if (this->stats != nullptr) {
+                this->stats->searches++;
+            }
+        }
+
+        ~SearchTimer() {
+            if (this->stats != nullptr) {
+                this->stats->elapsedNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,146 @@
+// FlatGraph represents a read-only compressed sparse row copy of an adjacency list graph (it models the GraphSearch graph concept)
+#ifndef FLAT_GRAPH
+#define FLAT_GRAPH
+
+#include <vector>
+#include <unordered_map>
+#include "graph.hpp"
+
+// FlatGraph stores each vertex's outgoing arcs contiguously, indexed by vertex id
+template <typename V, typename E>
+class FlatGraph {
+    private:
+        std::vector<Vertex<V>*> vertexList;
+        std::unordered_map<Vertex<V>*, int> ids;
+
+        std::vector<int> offsets;      // Arcs of vertex v are [offsets[v], offsets[v + 1])
+        std::vector<int> targets;      // Vertex id each arc leads to
+        std::vector<E> weights;        // Cost of each arc
+        std::vector<Edge<E>*> edgeList; // Edge of the original graph each arc came from
+
+        std::vector<int> incomingOffsets; // Arcs into vertex v are incomingArcs[incomingOffsets[v] .. incomingOffsets[v + 1])
+        std::vector<int> incomingArcs;
+        std::vector<int> sources;         // Vertex id each arc leaves from
+
+    public:
+        typedef E Cost;
+        typedef int VertexId;
+        typedef int ArcId;
+
+        // Default constructor for an empty flat graph
+        FlatGraph() {
+            this->offsets.push_back(0);
+            this->incomingOffsets.push_back(0);
+        }
+
+        // Flatten an adjacency list graph (vertex ids follow the order of graph->vertices())
+        FlatGraph(AdjacencyListGraph<V, E> *graph) {
+            this->vertexList = graph->vertices();
+            this->ids.reserve(this->vertexList.size());
+            for (typename std::vector<Vertex<V>*>::size_type i = 0; i < this->vertexList.size(); i++) {
+                this->ids[this->vertexList.at(i)] = i;
+            }
+
+            this->offsets.reserve(this->vertexList.size() + 1);
+            this->offsets.push_back(0);
+            for (Vertex<V> *v : this->vertexList) {
+                for (Edge<E> *e : *graph->outgoingEdges(v)) {
+                    this->targets.push_back(this->ids.at(graph->opposite(v, e)));
+                    this->weights.push_back(e->getElement());
+                    this->edgeList.push_back(e);
+                    this->sources.push_back(this->offsets.size() - 1);
+                }
+                this->offsets.push_back(this->targets.size());
+            }
+
+            // Bucket the arcs by target for backward searches
+            this->incomingOffsets = std::vector<int>(this->vertexList.size() + 1, 0);
+            for (int target : this->targets) {
+                this->incomingOffsets[target + 1]++;
+            }
+            for (typename std::vector<int>::size_type v = 0; v < this->vertexList.size(); v++) {
+                this->incomingOffsets[v + 1] += this->incomingOffsets[v];
+            }
+
+            std::vector<int> next(this->incomingOffsets.begin(), this->incomingOffsets.end() - 1);
+            this->incomingArcs = std::vector<int>(this->targets.size());
+            for (typename std::vector<int>::size_type arc = 0; arc < this->targets.size(); arc++) {
+                this->incomingArcs[next[this->targets[arc]]++] = arc;
+            }
+        }
+
+        // Return the number of vertices in the graph
+        int numVertices() {
+            return this->vertexList.size();
+        }
+
+        // Return the number of arcs in the graph
+        int numEdges() {
+            return this->targets.size();
+        }
+
+        // Get the id of a vertex (or -1 if it is not in the graph)
+        int id(Vertex<V> *vertex) {
+            typename std::unordered_map<Vertex<V>*, int>::iterator it = this->ids.find(vertex);
+            return it == this->ids.end() ? -1 : it->second;
+        }
+
+        // Get the vertex with a given id
+        Vertex<V> *vertex(int id) {
+            return this->vertexList.at(id);
+        }
+
+        // Get the first arc of a vertex
+        int arcsBegin(int v) {
+            return this->offsets[v];
+        }
+
+        // Get one past the last arc of a vertex
+        int arcsEnd(int v) {
+            return this->offsets[v + 1];
+        }
+
+        // Get the vertex id an arc leads to
+        int target(int arc) {
+            return this->targets[arc];
+        }
+
+        // Get the cost of an arc
+        E weight(int arc) {
+            return this->weights[arc];
+        }
+
+        // Call visit(arc, neighbor, cost) for each outgoing arc of a vertex
+        template <typename F>
+        void forEachArc(int v, F visit) {
+            for (int arc = this->offsets[v]; arc < this->offsets[v + 1]; arc++) {
+                visit(arc, this->targets[arc], this->weights[arc]);
+            }
+        }
+
+        // Call visit(arc, neighbor, cost) for each arc leading into a vertex
+        template <typename F>
+        void forEachIncomingArc(int v, F visit) {
+            for (int i = this->incomingOffsets[v]; i < this->incomingOffsets[v + 1]; i++) {
+                int arc = this->incomingArcs[i];
+                visit(arc, this->sources[arc], this->weights[arc]);
+            }
+        }
+
+        // Get the arc from one vertex to another (or -1 if they are not adjacent)
+        int arcBetween(int from, int to) {
+            for (int arc = this->offsets[from]; arc < this->offsets[from + 1]; arc++) {
+                if (this->targets[arc] == to) {
+                    return arc;
+                }
+            }
+            return -1;
+        }
+
+        // Get the edge of the original graph an arc came from
+        Edge<E> *edge(int arc) {
+            return this->edgeList[arc];
+        }
+};
+
+#endif
@@ -10,6 +10,7 @@
 #include <map>
 #include <sstream>
 #include <random>
+#include <cstdint>
 #include "vertex.hpp"
 
 // Vertex base (to be implemented later)
@@ -129,6 +130,11 @@ class AdjacencyListGraph {
         std::vector<Edge<E>*> edgeList;
 
     public:
+        // Types of the GraphSearch graph concept
+        typedef E Cost;
+        typedef Vertex<V> *VertexId;
+        typedef Edge<E> *ArcId;
+
         // Default constructor for an adjacency list graph
         AdjacencyListGraph() : AdjacencyListGraph<V, E>(false) {}
 
@@ -173,6 +179,22 @@ class AdjacencyListGraph {
             return vertex->getIncoming();
         }
 
+        // Call visit(edge, neighbor, cost) for each outgoing edge of a vertex
+        template <typename F>
+        void forEachArc(Vertex<V> *v, F visit) {
+            for (Edge<E> *e : *this->outgoingEdges(v)) {
+                visit(e, this->opposite(v, e), e->getElement());
+            }
+        }
+
+        // Call visit(edge, neighbor, cost) for each incoming edge of a vertex
+        template <typename F>
+        void forEachIncomingArc(Vertex<V> *v, F visit) {
+            for (Edge<E> *e : *this->incomingEdges(v)) {
+                visit(e, this->opposite(v, e), e->getElement());
+            }
+        }
+
         // Return an edge associated with two vertices (if it exists)
         Edge<E> *getEdge(Vertex<V> *v1, Vertex<V> *v2) {
             ALVertex<V, E> *vertex1 = validateALVertex(v1);
@@ -252,8 +274,59 @@ class AdjacencyListGraph {
             delete vertex;
         }
 
+        // Take a vertex and its edges out of the graph without deleting them (put them back with attachVertex and attachEdge)
+        void detachVertex(Vertex<V> *v) {
+            ALVertex<V, E> *vertex = validateALVertex(v);
+
+            std::vector<Edge<E>*> incident = *vertex->getOutgoing();
+            incident.insert(incident.end(), vertex->getIncoming()->begin(), vertex->getIncoming()->end());
+            for (Edge<E> *e : incident) {
+                this->detachEdge(e);
+            }
+
+            for (typename std::vector<Vertex<V> *>::iterator it = this->vertexList.begin(); it != this->vertexList.end(); it++) {
+                if (*it == v) {
+                    this->vertexList.erase(it);
+                    break;
+                }
+            }
+        }
+
+        // Take every vertex and edge out of the graph without deleting them (put them back with attachVertex and attachEdge)
+        void detachAll() {
+            for (Vertex<V> *v : this->vertexList) {
+                ALVertex<V, E> *vertex = validateALVertex(v);
+                vertex->getOutgoing()->clear();
+                vertex->getIncoming()->clear();
+            }
+
+            this->vertexList.clear();
+            this->edgeList.clear();
+        }
+
+        // Put a detached vertex back into the graph
+        void attachVertex(Vertex<V> *vertex) {
+            this->vertexList.push_back(vertex);
+        }
+
+        // Put a detached edge back into the graph
+        void attachEdge(Edge<E> *e) {
+            ALEdge<V, E> *edge = validateALEdge(e);
+
+            std::array<Vertex<V>*, 2> ends = edge->getEndpoints();
+            this->edgeList.push_back(edge);
+            validateALVertex(ends[0])->addOutgoing(edge);
+            validateALVertex(ends[1])->addIncoming(edge);
+        }
+
         // Remove an edge from the graph
         void removeEdge(Edge<E> *e) {
+            this->detachEdge(e);
+            delete e;
+        }
+
+        // Take an edge out of the graph without deleting it (put it back with attachEdge)
+        void detachEdge(Edge<E> *e) {
             ALEdge<V, E> *edge = validateALEdge(e);
 
             // Get the vertex endpoints
@@ -283,8 +356,6 @@ class AdjacencyListGraph {
                     break;
                 } 
             }
-
-            delete e;
         }
 
         // Find the opposite vertex from a given edge and vertex
@@ -507,6 +578,39 @@ void readGridGraphFromCSV(AdjacencyListGraph<Grid<E>, E> *graph, std::string fil
     }
 }
 
+// Fingerprint a graph's structure (vertex order, edges and weights) so files precomputed from it can be checked for staleness
+template <typename V, typename E>
+uint64_t fingerprintGraph(AdjacencyListGraph<V, E> *graph) {
+    std::vector<Vertex<V>*> vertices = graph->vertices();
+    std::map<Vertex<V>*, int> vertexIndex;
+    for (typename std::vector<Vertex<V>*>::size_type i = 0; i < vertices.size(); i++) {
+        vertexIndex[vertices.at(i)] = i;
+    }
+
+    // FNV-1a over each edge written as "origin>destination:weight;"
+    uint64_t hash = 14695981039346656037ULL;
+    for (typename std::vector<Vertex<V>*>::size_type i = 0; i < vertices.size(); i++) {
+        for (Edge<E> *e : *graph->outgoingEdges(vertices.at(i))) {
+            std::ostringstream stream;
+            stream << i << ">" << vertexIndex[graph->opposite(vertices.at(i), e)] << ":" << e->getElement() << ";";
+
+            for (char c : stream.str()) {
+                hash ^= (unsigned char) c;
+                hash *= 1099511628211ULL;
+            }
+        }
+    }
+
+    return hash;
+}
+
+// Parse a field read back from a precomputed file (returns false unless the whole field is a value of the given type)
+template <typename T>
+bool parseField(const std::string &field, T *value) {
+    std::istringstream stream(field);
+    return (stream >> *value) && (stream >> std::ws).eof();
+}
+
 // Generate a random graph according to given parameters
 void generateRandomGraph(AdjacencyListGraph<std::string, std::string> *graph, int verticesCount, int minOutgoingEdges, int minIncomingEdges, int maxWeight);
 
@@ -0,0 +1,30 @@
+// Grid maps are plain text files with one line per row of tiles, where 'x' marks an obstacle and anything else is open
+#ifndef GRID_MAP
+#define GRID_MAP
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+// Read a grid map into a row-major list of blocked tiles (rows and columns missing from the file are open)
+inline bool readGridMap(std::string filename, int rows, int cols, std::vector<bool> *blocked) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    blocked->assign(rows * cols, false);
+
+    std::string line;
+    for (int row = 0; row < rows && std::getline(file, line); row++) {
+        for (int col = 0; col < cols && col < (int) line.size(); col++) {
+            if (line[col] == 'x') {
+                blocked->at(row * cols + col) = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,130 @@
+// ImplicitGridGraph represents a 4-connected grid whose edges are computed from (row, col) instead of stored (it models the GraphSearch graph concept)
+#ifndef IMPLICIT_GRID_GRAPH
+#define IMPLICIT_GRID_GRAPH
+
+#include <vector>
+
+// ImplicitGridGraph stores one obstacle bit per cell, plus a cost per cell only once a cell's cost is changed
+template <typename E>
+class ImplicitGridGraph {
+    private:
+        int rows = 0;
+        int cols = 0;
+
+        E uniformCost;
+        std::vector<E> cellCosts; // Cost of moving into each cell (empty while every cell costs uniformCost)
+        std::vector<bool> blocked;
+
+        // Call visit(arc, neighbor, cost) if a cell is inside the grid and open (the arc is the cell entered, which costs cost to move into)
+        template <typename F>
+        void visitCell(int row, int col, int arc, E cost, F &visit) {
+            if (row < 0 || row >= this->rows || col < 0 || col >= this->cols) {
+                return;
+            }
+
+            int id = row * this->cols + col;
+            if (!this->blocked[id]) {
+                visit(arc == -1 ? id : arc, id, arc == -1 ? this->cost(id) : cost);
+            }
+        }
+
+        // Get the cost of moving into a cell id
+        E cost(int id) {
+            return this->cellCosts.size() > 0 ? this->cellCosts[id] : this->uniformCost;
+        }
+
+    public:
+        typedef E Cost;
+        typedef int VertexId;
+        typedef int ArcId; // Id of the cell an arc leads into
+
+        // Default constructor for an empty grid
+        ImplicitGridGraph() {
+            this->uniformCost = E();
+        }
+
+        // Create an open grid where moving into any cell costs the same
+        ImplicitGridGraph(int rows, int cols, E uniformCost) {
+            this->rows = rows;
+            this->cols = cols;
+            this->uniformCost = uniformCost;
+            this->blocked = std::vector<bool>(rows * cols, false);
+        }
+
+        // Return the number of cells in the grid (blocked cells keep their ids)
+        int numVertices() {
+            return this->rows * this->cols;
+        }
+
+        // Get the id of a cell
+        int id(int row, int col) {
+            return row * this->cols + col;
+        }
+
+        // Get the row of a cell id
+        int row(int id) {
+            return id / this->cols;
+        }
+
+        // Get the column of a cell id
+        int column(int id) {
+            return id % this->cols;
+        }
+
+        // Return true if a cell is outside of the grid or blocked
+        bool isBlocked(int row, int col) {
+            if (row < 0 || row >= this->rows || col < 0 || col >= this->cols) {
+                return true;
+            }
+            return this->blocked[row * this->cols + col];
+        }
+
+        // Block or unblock a cell
+        void setBlocked(int row, int col, bool isBlocked) {
+            this->blocked[row * this->cols + col] = isBlocked;
+        }
+
+        // Get the cost of moving into a cell
+        E getCost(int row, int col) {
+            return this->cost(row * this->cols + col);
+        }
+
+        // Set the cost of moving into a cell
+        void setCost(int row, int col, E cost) {
+            if (this->cellCosts.size() == 0) {
+                this->cellCosts = std::vector<E>(this->rows * this->cols, this->uniformCost);
+            }
+            this->cellCosts[row * this->cols + col] = cost;
+        }
+
+        // Call visit(arc, neighbor, cost) for each open neighbour of a cell (in the order up, left, right, down)
+        template <typename F>
+        void forEachArc(int v, F visit) {
+            int row = v / this->cols;
+            int col = v % this->cols;
+
+            this->visitCell(row - 1, col, -1, E(), visit);
+            this->visitCell(row, col - 1, -1, E(), visit);
+            this->visitCell(row, col + 1, -1, E(), visit);
+            this->visitCell(row + 1, col, -1, E(), visit);
+        }
+
+        // Call visit(arc, neighbor, cost) for each open neighbour that can move into a cell (none if the cell is blocked)
+        template <typename F>
+        void forEachIncomingArc(int v, F visit) {
+            if (this->blocked[v]) {
+                return;
+            }
+
+            int row = v / this->cols;
+            int col = v % this->cols;
+            E cost = this->cost(v);
+
+            this->visitCell(row - 1, col, v, cost, visit);
+            this->visitCell(row, col - 1, v, cost, visit);
+            this->visitCell(row, col + 1, v, cost, visit);
+            this->visitCell(row + 1, col, v, cost, visit);
+        }
+};
+
+#endif